@@ -0,0 +1,29 @@
+# - Try to find the EGL library
+# Once done this will define
+#
+#  EGL_FOUND - system has EGL
+#  EGL_INCLUDE_DIR - the EGL include directory
+#  EGL_LIBRARY - Link this to use EGL
+#
+# Redistribution and use is allowed according to the terms of the BSD license.
+# For details see the accompanying COPYING-CMAKE-SCRIPTS file.
+
+if (EGL_LIBRARY AND EGL_INCLUDE_DIR)
+  # in cache already
+  set(EGL_FOUND TRUE)
+else (EGL_LIBRARY AND EGL_INCLUDE_DIR)
+
+  find_path(EGL_INCLUDE_DIR EGL/egl.h
+  )
+
+  find_library(EGL_LIBRARY
+    NAMES EGL
+  )
+
+  include(FindPackageHandleStandardArgs)
+  find_package_handle_standard_args(EGL DEFAULT_MSG EGL_LIBRARY EGL_INCLUDE_DIR)
+  # ensure that they are cached
+  set(EGL_INCLUDE_DIR ${EGL_INCLUDE_DIR} CACHE INTERNAL "The EGL include path")
+  set(EGL_LIBRARY ${EGL_LIBRARY} CACHE INTERNAL "The libraries needed to use EGL")
+
+endif (EGL_LIBRARY AND EGL_INCLUDE_DIR)
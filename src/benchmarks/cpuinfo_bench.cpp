@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////////////
+// cpuinfo_bench.cpp                                                    //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+/*
+ * cpuinfo_bench: CpuInfoTable::read() against the repeated readFromFile()
+ * scans cpuInfo() used to do, on a 256 CPU fixture in the layout of x86.
+ * A file on disk is kinder to the old code than /proc/cpuinfo, which the
+ * kernel generates again on every open.
+ */
+
+#include "cpuinfo.h"
+
+#include <QFile>
+#include <QTemporaryFile>
+#include <QTextStream>
+#include <QtTest>
+
+#define FIXTURE_CPUS 256
+
+/*
+ * As it was in sysinfo.cpp, without the kDebug() for every call
+ */
+static QString readFromFile( const QString & filename, const QString & info = QString(),
+                             const char * sep = 0, bool returnlast = false )
+{
+    QFile file( filename );
+
+    if ( !file.exists() || !file.open( QIODevice::ReadOnly ) )
+        return QString::null;
+
+    QTextStream stream( &file );
+    QString line, result;
+
+    do
+    {
+        line = stream.readLine();
+        if ( !line.isEmpty() )
+        {
+            if ( !sep )
+                result = line;
+            else if ( line.startsWith( info ) )
+                result = line.section( sep, 1, 1 );
+
+            if (!result.isEmpty() && !returnlast)
+                return result;
+        }
+    } while (!line.isNull());
+
+    return result;
+}
+
+class CpuInfoBench : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void repeatedScans();
+    void singlePass();
+
+private:
+    QTemporaryFile m_fixture;
+};
+
+void CpuInfoBench::initTestCase()
+{
+    QVERIFY( m_fixture.open() );
+    QTextStream out( &m_fixture );
+    for ( int cpu = 0; cpu < FIXTURE_CPUS; ++cpu )
+    {
+        out << "processor\t: " << cpu << "\n"
+            << "vendor_id\t: GenuineIntel\n"
+            << "cpu family\t: 6\n"
+            << "model\t\t: 143\n"
+            << "model name\t: Intel(R) Xeon(R) Platinum 8480+\n"
+            << "stepping\t: 8\n"
+            << "cpu MHz\t\t: 2000.000\n"
+            << "cache size\t: 107520 KB\n"
+            << "physical id\t: " << cpu / ( FIXTURE_CPUS / 2 ) << "\n"
+            << "siblings\t: " << FIXTURE_CPUS / 2 << "\n"
+            << "core id\t\t: " << cpu % ( FIXTURE_CPUS / 4 ) << "\n"
+            << "cpu cores\t: " << FIXTURE_CPUS / 4 << "\n"
+            << "flags\t\t: fpu vme de pse tsc msr pae mce cx8 apic sep mtrr pge mca cmov pat pse36 clflush dts "
+               "acpi mmx fxsr sse sse2 ss ht tm pbe syscall nx pdpe1gb rdtscp lm constant_tsc art arch_perfmon "
+               "pebs bts rep_good nopl xtopology nonstop_tsc cpuid aperfmperf tsc_known_freq pni pclmulqdq dtes64 "
+               "monitor ds_cpl vmx smx est tm2 ssse3 sdbg fma cx16 xtpr pdcm pcid dca sse4_1 sse4_2 x2apic movbe "
+               "popcnt tsc_deadline_timer aes xsave avx f16c rdrand lahf_lm abm 3dnowprefetch cpuid_fault epb cat_l3 "
+               "cat_l2 cdp_l3 invpcid_single intel_ppin cdp_l2 ssbd mba ibrs ibpb stibp ibrs_enhanced tpr_shadow "
+               "flexpriority ept vpid ept_ad fsgsbase tsc_adjust bmi1 avx2 smep bmi2 erms invpcid cqm rdt_a avx512f "
+               "avx512dq rdseed adx smap avx512ifma clflushopt clwb intel_pt avx512cd sha_ni avx512bw avx512vl "
+               "xsaveopt xsavec xgetbv1 xsaves cqm_llc cqm_occup_llc cqm_mbm_total cqm_mbm_local split_lock_detect "
+               "avx_vnni avx512_bf16 wbnoinvd dtherm ida arat pln pts hfi vnmi avx512vbmi umip pku ospke waitpkg "
+               "avx512_vbmi2 gfni vaes vpclmulqdq avx512_vnni avx512_bitalg tme avx512_vpopcntdq la57 rdpid "
+               "bus_lock_detect cldemote movdiri movdir64b enqcmd fsrm md_clear serialize tsxldtrk pconfig "
+               "arch_lbr ibt amx_bf16 avx512_fp16 amx_tile amx_int8 flush_l1d arch_capabilities\n"
+            << "bogomips\t: 4000.00\n"
+            << "clflush size\t: 64\n"
+            << "cache_alignment\t: 64\n"
+            << "address sizes\t: 46 bits physical, 57 bits virtual\n"
+            << "power management:\n\n";
+    }
+    out.flush();
+    m_fixture.close();
+}
+
+void CpuInfoBench::repeatedScans()
+{
+    // the calls cpuInfo() made on x86, "clock" and "cpu" only come in on PPC
+    const QString path = m_fixture.fileName();
+    QString speed, cores, model;
+    QBENCHMARK
+    {
+        speed = readFromFile( path, "cpu MHz", ":" );
+        cores = readFromFile( path, "processor", ":", true );
+        model = readFromFile( path, "model name", ":" );
+    }
+    QCOMPARE( cores.trimmed().toInt(), FIXTURE_CPUS - 1 );
+    QVERIFY( !speed.isEmpty() && !model.isEmpty() );
+}
+
+void CpuInfoBench::singlePass()
+{
+    const QByteArray path = QFile::encodeName( m_fixture.fileName() );
+    CpuInfoTable cpus;
+    QBENCHMARK
+    {
+        cpus.read( path.constData() );
+    }
+    QCOMPARE( cpus.count(), FIXTURE_CPUS );
+    QVERIFY( cpus.at( 0 ).mhz == 2000.0f && !cpus.model( 0 ).isEmpty() );
+}
+
+QTEST_MAIN( CpuInfoBench )
+
+#include "cpuinfo_bench.moc"
@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////
+// disks_bench.cpp                                                      //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+/*
+ * disks_bench: the disk table of 200 synthetic devices, rendered the way
+ * diskInfo() did before the asset lookups were memoized, and now with
+ * kio_sysinfoProtocol::diskCells() and diskRows(). diskCells() only runs
+ * for the first request and for devices which changed, so it's measured
+ * apart.
+ */
+
+#include "sysinfo.h"
+
+#include <QColor>
+#include <QtTest>
+
+#include <kglobal.h>
+#include <kiconloader.h>
+#include <klocale.h>
+#include <kstandarddirs.h>
+#include <qtest_kde.h>
+
+#define DISK_COUNT 200
+
+/*
+ * The helpers of sysinfo.cpp, as they were
+ */
+static QString formattedUnit( quint64 value, int post=1 )
+{
+    if (value >= (1024 * 1024))
+        if (value >= (1024 * 1024 * 1024))
+            return i18n("%1 GiB", KGlobal::locale()->formatNumber(value / (1024 * 1024 * 1024.0),
+                        post));
+        else
+            return i18n("%1 MiB", KGlobal::locale()->formatNumber(value / (1024 * 1024.0), post));
+    else
+        return i18n("%1 KiB", KGlobal::locale()->formatNumber(value / 1024.0, post));
+}
+
+static QString htmlQuote(const QString& _s)
+{
+    QString s(_s);
+    return s.replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;");
+}
+
+static QString hdicon()
+{
+    QString hdimagePath = "file://" + KStandardDirs::locate( "data", "sysinfo/about/images/hdd.png");
+    return QString( "<img src=\"%1\" width=\"32\" height=\"32\" valign=\"bottom\"/>").arg( hdimagePath );
+}
+
+static QString icon( const QString & name, int size )
+{
+    QString path = KIconLoader::global()->iconPath( name, -size );
+    return QString( "<img src=\"file:%1\" width=\"%2\" height=\"%3\" valign=\"bottom\"/>" )
+        .arg( htmlQuote(path) ).arg( size ).arg( size );
+}
+
+/*
+ * The loop body of diskInfo() before the memoized lookups
+ */
+static QString oldDiskRows( const DiskInfo & di )
+{
+    QString result;
+    QString tooltip = i18n("Press the right mouse button for more options (such as Mount or Eject.)");
+
+    unsigned int percent = 0;
+    quint64 usage = di.total - di.avail;
+    if (di.total)
+        percent = usage / ( di.total / 100);
+
+    QString media = "file://" + di.deviceNode;
+
+    QString unmount;
+    if (di.removable)
+        unmount = QString("<a href=\"#unmount=%1\">%2</a>").
+                  arg( di.id ).arg( icon( "media-eject", 16 ) );
+
+    result += QString( "<tr><td rowspan=\"2\">%1</td><td><a href=\"%2\" title=\"%7\">%3</a></td>" \
+                       "<td>%4</td><td>%5</td><td>%6</td><td rowspan=\"2\">%8</td></tr>\n" ).
+              arg( hdicon() ).arg( htmlQuote(media) ).arg( htmlQuote(di.label) ).arg( di.fsType ).
+              arg( di.total ? formattedUnit( di.total) : QString::null).
+              arg( di.mounted ? formattedUnit( di.avail ) : QString::null).
+              arg( htmlQuote( tooltip ) ).
+              arg(unmount);
+
+    result += QString("<tr><td colspan=\"4\" %1>").arg( di.mounted ? "class=\"bar\"" : "");
+    if (di.mounted)
+    {
+        QColor c;
+        c.setHsv(100-percent, 180, 230);
+        QString dp = formattedUnit(usage).replace(" ", "&nbsp;");
+        QString dpl, dpr;
+        if (percent >= 50)
+            dpl = dp;
+        else
+            dpr = "<span>" + dp + "</span>";
+        result += QString("<div><span class=\"filled\" style=\"width: %1%; background-color: %4\">"
+                          "%2</span>%3</div>\n")
+                  .arg(percent).arg(dpl).arg(dpr).arg(c.name());
+    }
+    result += "</td></tr>\n";
+    return result;
+}
+
+class DisksBench : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+    void perRowLookups();
+    void memoizedFirstRequest();
+    void memoizedLaterRequest();
+
+private:
+    QList<DiskInfo> m_disks;
+};
+
+void DisksBench::initTestCase()
+{
+    for ( int i = 0; i < DISK_COUNT; ++i )
+    {
+        DiskInfo di;
+        di.id = QString( "/org/kde/solid/udisks2/block_devices/sd%1" ).arg( i );
+        di.name = di.label = QString( "Volume %1" ).arg( i );
+        di.deviceNode = QString( "/dev/sd%1" ).arg( i );
+        di.mountPoint = QString( "/srv/volume%1" ).arg( i );
+        di.fsType = "ext4";
+        di.mounted = true;
+        di.removable = i % 10 == 0;     // a USB stick every now and then
+        di.iconName = di.removable ? "drive-removable-media-usb" : "drive-harddisk";
+        di.total = Q_UINT64_C( 500 ) << 30;
+        di.avail = di.total / DISK_COUNT * i;
+        di.unresponsive = false;
+        di.io.valid = false;
+        m_disks << di;
+    }
+}
+
+void DisksBench::perRowLookups()
+{
+    QString html;
+    QBENCHMARK
+    {
+        html.clear();
+        Q_FOREACH ( const DiskInfo & di, m_disks )
+            html += oldDiskRows( di );
+    }
+    QVERIFY( html.count( "<tr>" ) == 2 * DISK_COUNT );
+}
+
+void DisksBench::memoizedFirstRequest()
+{
+    QString html;
+    QBENCHMARK
+    {
+        html.clear();
+        for ( QList<DiskInfo>::Iterator it = m_disks.begin(); it != m_disks.end(); ++it )
+        {
+            kio_sysinfoProtocol::diskCells( *it );
+            html += kio_sysinfoProtocol::diskRows( *it, QString() );
+        }
+    }
+    QVERIFY( html.count( "<tr>" ) == 2 * DISK_COUNT );
+}
+
+void DisksBench::memoizedLaterRequest()
+{
+    for ( QList<DiskInfo>::Iterator it = m_disks.begin(); it != m_disks.end(); ++it )
+        kio_sysinfoProtocol::diskCells( *it );
+
+    QString html;
+    QBENCHMARK
+    {
+        html.clear();
+        Q_FOREACH ( const DiskInfo & di, m_disks )
+            html += kio_sysinfoProtocol::diskRows( di, QString() );
+    }
+    QVERIFY( html.count( "<tr>" ) == 2 * DISK_COUNT );
+}
+
+QTEST_KDEMAIN( DisksBench, NoGUI )
+
+#include "disks_bench.moc"
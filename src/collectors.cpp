@@ -0,0 +1,549 @@
+//////////////////////////////////////////////////////////////////////////
+// collectors.cpp                                                       //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+/*
+ * The collectors of kio_sysinfoProtocol and what else the sampler daemon
+ * shares with the slave, kept apart from the slave so that the daemon
+ * doesn't link KIO.
+ */
+
+#include "sysinfo.h"
+#include "cpuinfo.h"
+#include "cpufreq.h"
+#include "cputopology.h"
+#include "diskspace.h"
+#include "factcache.h"
+#include "glquery.h"
+#include "history.h"
+#include "meminfo.h"
+#include "sensors.h"
+#include "snapshotlog.h"
+
+#include <config-kiosysinfo.h>
+
+#ifdef HAVE_HD
+#include <hd.h>
+#endif
+
+#include <QFile>
+#include <QMutex>
+#include <QRegExp>
+#include <QTextStream>
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/sysinfo.h>
+#include <sys/utsname.h>
+
+#include <kdebug.h>
+#include <kdeversion.h>
+#include <kglobal.h>
+#include <kstandarddirs.h>
+#include <KConfigGroup>
+#include <KDesktopFile>
+
+// defaults for [History] Minutes and Resolution (s) in kio_sysinforc: how far
+// back the sparklines go and the time between their points
+#define HISTORY_MINUTES 30
+#define HISTORY_RESOLUTION_S 10
+
+// defaults for [Log] Interval (s) and MaxSize (MiB) in kio_sysinforc: the
+// minimum time between two logged snapshots and when the log is rolled
+#define LOG_INTERVAL_S 60
+#define LOG_MAX_SIZE_MB 16
+
+static QString readFromFile( const QString & filename, const QString & info = QString(),
+                             const char * sep = 0, bool returnlast = false )
+{
+    kDebug() << "Reading " << info << " from " << filename;
+
+    QFile file( filename );
+
+    if ( !file.exists() || !file.open( QIODevice::ReadOnly ) )
+        return QString::null;
+
+    QTextStream stream( &file );
+    QString line, result;
+
+    do
+    {
+        line = stream.readLine();
+        if ( !line.isEmpty() )
+        {
+            if ( !sep )
+                result = line;
+            else if ( line.startsWith( info ) )
+                result = line.section( sep, 1, 1 );
+
+            if (!result.isEmpty() && !returnlast)
+                return result;
+        }
+    } while (!line.isNull());
+
+    return result;
+}
+
+kio_sysinfoProtocol::Collector kio_sysinfoProtocol::collector( int id )
+{
+    static const Collector collectors[COLL_COUNT] = {
+        &kio_sysinfoProtocol::cpuInfo,
+        &kio_sysinfoProtocol::osInfo,
+        &kio_sysinfoProtocol::kdeInfo,
+        &kio_sysinfoProtocol::glInfo,
+        &kio_sysinfoProtocol::waylandInfo,
+        &kio_sysinfoProtocol::memoryInfo
+    };
+    return collectors[id];
+}
+
+int kio_sysinfoProtocol::collect( SysInfoSnapshot & info, int which )
+{
+    int results = 0;
+    for ( int i = 0; i < COLL_COUNT; ++i )
+        if ( ( which & ( 1 << i ) ) && collector( i )( info ) )
+            results |= 1 << i;
+    return results;
+}
+
+SnapshotLog * kio_sysinfoProtocol::createLog( qint64 & interval )
+{
+    const KConfigGroup cg( KGlobal::config(), "Log" );
+    if ( !cg.readEntry( "Enabled", false ) )
+        return 0;
+
+    QString path = cg.readPathEntry( "Path", QString() );
+    if ( path.isEmpty() )
+        path = KStandardDirs::locateLocal( "data", "kio_sysinfo/snapshots.log" );
+    interval = qint64( qMax( 1, cg.readEntry( "Interval", LOG_INTERVAL_S ) ) ) * 1000;
+    return new SnapshotLog( QFile::encodeName( path ),
+                            qint64( qMax( 1, cg.readEntry( "MaxSize", LOG_MAX_SIZE_MB ) ) ) * 1024 * 1024 );
+}
+
+History * kio_sysinfoProtocol::createHistory()
+{
+    // a minutes of 0 turns it off
+    const KConfigGroup cg( KGlobal::config(), "History" );
+    const int minutes = cg.readEntry( "Minutes", HISTORY_MINUTES );
+    if ( minutes <= 0 )
+        return 0;
+
+    const KConfigGroup disks( KGlobal::config(), "Disks" );
+    History * history = new History( minutes, cg.readEntry( "Resolution", HISTORY_RESOLUTION_S ),
+                                     disks.readEntry( "StatfsTimeout", DISKSPACE_TIMEOUT_MS ),
+                                     disks.readEntry( "UnresponsiveRetryInterval", DISKSPACE_RETRY_S ) );
+    history->start( QThread::LowPriority );
+    return history;
+}
+
+bool kio_sysinfoProtocol::memoryInfo( SysInfoSnapshot & info )
+{
+    struct sysinfo si;
+    if ( sysinfo( &si ) != -1 )
+        info.setNumber( SysInfoSnapshot::SYSTEM_UPTIME, si.uptime );
+
+    // everything else from one pass over /proc/meminfo, so the figures are consistent
+    MemInfo mem;
+    if ( !mem.read() )
+        return false;
+
+    // reclaimable caches; shmem is counted in Cached but can't be dropped
+    const quint64 pageCache = mem.cached + mem.buffers;
+    const quint64 caches = ( pageCache > mem.shmem ? pageCache - mem.shmem : 0 ) + mem.sReclaimable;
+
+    info.setNumber( SysInfoSnapshot::MEM_TOTALRAM, mem.memTotal * 1024 );
+    info.setNumber( SysInfoSnapshot::MEM_FREERAM, mem.memFree * 1024 );
+    info.setNumber( SysInfoSnapshot::MEM_CACHED, caches * 1024 );
+    // the kernel's own estimate since 3.14, which also accounts for the
+    // watermarks and the part of the caches which is in use
+    info.setNumber( SysInfoSnapshot::MEM_AVAILABLE,
+                    ( mem.has( &MemInfo::memAvailable ) ? mem.memAvailable : mem.memFree + caches ) * 1024 );
+    info.setNumber( SysInfoSnapshot::MEM_SHMEM, mem.shmem * 1024 );
+    info.setNumber( SysInfoSnapshot::MEM_SUNRECLAIM, mem.sUnreclaim * 1024 );
+    if ( mem.hugePagesTotal )
+    {
+        info.setNumber( SysInfoSnapshot::MEM_HUGEPAGES_TOTAL, mem.hugePagesTotal * mem.hugepagesize * 1024 );
+        info.setNumber( SysInfoSnapshot::MEM_HUGEPAGES_FREE, mem.hugePagesFree * mem.hugepagesize * 1024 );
+    }
+
+    info.setNumber( SysInfoSnapshot::MEM_TOTALSWAP, mem.swapTotal * 1024 );
+    info.setNumber( SysInfoSnapshot::MEM_FREESWAP, mem.swapFree * 1024 );
+    if ( mem.zswapped )
+    {
+        info.setNumber( SysInfoSnapshot::MEM_ZSWAP, mem.zswap * 1024 );
+        info.setNumber( SysInfoSnapshot::MEM_ZSWAPPED, mem.zswapped * 1024 );
+    }
+
+    ZramInfo zram;
+    if ( zram.read() && zram.origDataSize )
+    {
+        info.setNumber( SysInfoSnapshot::MEM_ZRAM_USED, zram.memUsedTotal );
+        info.setNumber( SysInfoSnapshot::MEM_ZRAM_DATA, zram.origDataSize );
+    }
+
+    return true;
+}
+
+bool kio_sysinfoProtocol::cpuInfo( SysInfoSnapshot & info )
+{
+    CpuInfoTable cpus;
+    if ( cpus.read() )
+    {
+        info.setNumber( SysInfoSnapshot::CPU_SPEED, qRound64( cpus.at( 0 ).mhz * 1000.0 ) );
+        info.setNumber( SysInfoSnapshot::CPU_CORES, cpus.count() );
+        CpuTopology::system(); // read it here rather than when rendering
+        const QByteArray model = cpus.model( 0 );
+        if ( !model.isEmpty() )
+            info.setText( SysInfoSnapshot::CPU_MODEL, model );
+    }
+
+    // "cpu MHz" is a single value for CPU 0, cpufreq knows all of them
+    CpuFreq freq;
+    if ( freq.read() )
+        info.setNumber( SysInfoSnapshot::CPU_SPEED, freq.averageKHz() );
+
+    const QVector<SensorReading> readings = Sensors::system().read();
+    const int package = Sensors::cpuTemperature( readings );
+    if ( package >= 0 )
+        info.setNumber( SysInfoSnapshot::CPU_TEMP, qRound64( readings.at( package ).value / 1000.0 ) );
+
+    return info.has( SysInfoSnapshot::CPU_MODEL );
+}
+
+bool kio_sysinfoProtocol::glInfo( SysInfoSnapshot & info )
+{
+    /* This leaks like sieve. Since gfx cards usually don't happen
+       to change to something else while the computer is running,
+       run this just once and keep the results. A straggler from the
+       previous get() may still be in here, hence the lock. */
+    static QMutex mutex;
+    static bool beenhere = false;
+    static bool prevresult = false;
+    static SysInfoSnapshot previnfo;
+    QMutexLocker locker( &mutex );
+    if( beenhere )
+    {
+        if ( prevresult )
+            info.merge( previnfo );
+        return prevresult;
+    }
+    beenhere = true;
+
+#ifdef HAVE_HD
+    /* Prepare HD */
+    static hd_data_t hd_data;
+    static bool inited_hd = false;
+    if ( !inited_hd )
+    {
+        memset(&hd_data, 0, sizeof(hd_data));
+        inited_hd = true;
+    }
+
+    if (!hd_list(&hd_data, hw_display, 1, NULL))
+        return false;
+
+    hd_t *hd = hd_get_device_by_idx(&hd_data, hd_display_adapter(&hd_data));
+#endif
+
+    /* Build list of all loaded Xorg modules */
+    QStringList loaded_modules;
+    QFile file("/var/log/Xorg.0.log");
+    if (file.exists() && file.open(QIODevice::ReadOnly)) {
+        QTextStream stream(&file);
+        QString line;
+
+        while (!stream.atEnd()) {
+            line = stream.readLine();
+            QRegExp rx_mod_load("\\(II\\) LoadModule: \"([\\S]+)\"");
+            QRegExp rx_mod_unload("\\(II\\) UnloadModule: \"([\\S]+)\"");
+            if (rx_mod_load.indexIn(line) > -1) {
+                loaded_modules.append(rx_mod_load.cap(1));
+            } else if (rx_mod_unload.indexIn(line) > -1) {
+                loaded_modules.removeOne(rx_mod_unload.cap(1));
+            }
+        }
+    }
+
+    /* Names of possible 2D drivers. We will look for them in cached modules */
+    QStringList possible_2d_drivers;
+#ifdef HAVE_HD
+    if (hd) {
+        driver_info_t *di = hd->driver_info;
+        for (di = di; di; di = di->next) {
+            if (di->any.type == di_x11) {
+                possible_2d_drivers.append(di->x11.server);
+            } else if (di->any.type == di_module && di->module.names) {
+                possible_2d_drivers.append(di->module.names->str);
+            }
+        }
+    }
+#endif
+    possible_2d_drivers << "fglrx" << "intel" << "nouveau" << "nv" << "nvidia" << "openchrome" << "radeon" << "radeonhd" << "vboxvideo";
+    possible_2d_drivers << "vesa" << "fbdev";
+
+    /* Find first of possible 2D drivers that is actually loaded */
+    QString driver = QString::null;
+    for (int i = 0; i < possible_2d_drivers.size(); ++i) {
+        QString curr_driver = possible_2d_drivers.at(i);
+        if (loaded_modules.contains(curr_driver)) {
+            info.setText( SysInfoSnapshot::GFX_2D_DRIVER, curr_driver );
+            driver = curr_driver; /* FIXME */
+            break;
+        }
+    }
+
+    /* Grab OpenGL info. Creating a context is expensive, so the strings
+       are shared by all slave instances until the GPU, its kernel driver
+       or the GL libraries change. */
+    const QString key = QString::fromLatin1( GLQuery::deviceKey() );
+    FactCache::Values facts;
+    if ( !FactCache::lookup( "OpenGL", key, facts ) )
+    {
+        GLQuery::Strings strings;
+        if ( GLQuery::query( strings ) )
+        {
+            facts["Vendor"] = QString::fromUtf8( strings.vendor );
+            facts["Renderer"] = QString::fromUtf8( strings.renderer );
+            facts["Version"] = QString::fromUtf8( strings.version );
+            FactCache::store( "OpenGL", key, facts );
+        }
+    }
+    QString opengl_vendor = facts.value( "Vendor" );
+    QString opengl_renderer = facts.value( "Renderer" );
+    QString opengl_version = facts.value( "Version" );
+    QString opengl_mesa = QString::null;
+    QRegExp rx("Mesa (\\S+)");
+    if (rx.indexIn(opengl_version) > -1) {
+        opengl_mesa = rx.cap(1);
+    }
+
+    /* As first choice, use OpenGL info */
+    QString vendor = opengl_vendor;
+    QString model = opengl_renderer;
+    QString driver3d = QString::null;
+
+    /* Determine 3D driver from OpenGL info */
+    QRegExp rx_g("Gallium.+on ([\\S]+)");
+    if (opengl_renderer.contains("Software Rasterizer")) { /* swrast */
+        driver3d = "swrast";
+        info.setNumber( SysInfoSnapshot::GFX_ACCELERATED, 0 );
+    } else if (rx_g.indexIn(opengl_renderer) > -1) { /* Gallium */
+        model = rx_g.cap(1);
+        if (opengl_vendor.contains("R300")) {
+            vendor = GFX_VENDOR_ATI;
+            driver3d = "R300 Gallium";
+        } else if (opengl_vendor.contains("R600")) {
+            vendor = GFX_VENDOR_ATI;
+            driver3d = "R600 Gallium";
+        } else if (opengl_vendor.contains("nouveau")) {
+            vendor = GFX_VENDOR_NVIDIA;
+            driver3d = "nouveau Gallium";
+        } else {
+            driver3d = "Gallium";
+        }
+    } else if (opengl_renderer.contains("Mesa DRI")) { /* Classic Mesa */
+        QRegExp rx_r("(R[0-9]00) \\(([^\\)]+)\\)");
+        if (rx_r.indexIn(opengl_renderer) > -1) {
+            vendor = GFX_VENDOR_ATI;
+            model = rx_r.cap(2);
+            driver3d = rx_r.cap(1) + " classic";
+        } else {
+            driver3d = "Mesa classic";
+        }
+    } else if (opengl_vendor.contains("ATI") || opengl_vendor.contains("Advanced Micro Devices")) { /* Proprietary ATI */
+        vendor = GFX_VENDOR_ATI;
+        driver3d = "ATI";
+    } else if (opengl_vendor.contains("NVIDIA")) { /* Proprietary NVIDIA */
+        vendor = GFX_VENDOR_NVIDIA;
+        QRegExp rx_n("(NVIDIA [0-9\\.]+)");
+        if (rx_n.indexIn(opengl_version) > -1) {
+            driver3d = rx_n.cap(1);
+        } else {
+            driver3d = "NVIDIA";
+        }
+    }
+
+#ifdef HAVE_HD
+    /* Using HD (when possible) should gave the best result */
+    if (hd) {
+        vendor = hd->vendor.name;
+        /* GFX_MODEL maybe empty with newer models */
+        if (!!hd->device.name) {
+            model = hd->device.name;
+        }
+    }
+#endif
+
+    info.setText( SysInfoSnapshot::GFX_VENDOR, vendor );
+    info.setText( SysInfoSnapshot::GFX_MODEL, model );
+    info.setText( SysInfoSnapshot::GFX_3D_DRIVER, driver3d );
+    info.setText( SysInfoSnapshot::GFX_MESA_VERSION, opengl_mesa );
+
+    previnfo = info;
+    prevresult = true;
+    return true;
+
+#if 0
+#ifdef HAVE_HD
+    GLQuery::Strings strings;
+    bool dri = false;
+    GLQuery::glx( strings, &dri );
+    QString renderer = strings.renderer;
+
+    if (!driver.isNull())
+    {
+        info.setText( SysInfoSnapshot::GFX_3D_DRIVER, driver );
+        info.setNumber( SysInfoSnapshot::GFX_ACCELERATED,
+                        dri || !renderer.contains( "Mesa GLX Indirect" ) );
+    }
+#else
+    info.setText( SysInfoSnapshot::GFX_3D_DRIVER, opengl_version );
+#endif
+
+    prevresult = true;
+    return true;
+#endif
+}
+
+/**
+ * Run @p command and return its output lines
+ */
+static QStringList commandOutput( const QString & command )
+{
+    QStringList lines;
+    /* FIXME: unsafe, replace popen with QProcess? */
+    FILE *fd = popen(QFile::encodeName(command), "r");
+    if (fd) {
+        QTextStream is(fd);
+        while (!is.atEnd())
+            lines << is.readLine();
+    }
+    if (fd) {
+        /* FIXME: this is hack to do not let QTextStream touch fd after closing
+         * it. Prevents whole kio_sysinfo from crashing */
+        pclose(fd);
+    }
+    return lines;
+}
+
+static void setFact( SysInfoSnapshot & info, SysInfoSnapshot::Text field, const FactCache::Values & facts,
+                     const char * name )
+{
+    const FactCache::Values::ConstIterator it = facts.constFind( QString::fromLatin1( name ) );
+    if ( it != facts.constEnd() && !it.value().isEmpty() )
+        info.setText( field, it.value() );
+}
+
+bool kio_sysinfoProtocol::kdeInfo( SysInfoSnapshot & info )
+{
+    //TODO: Don't hardcode the filename here
+    const QString plasmaDesktop = QString::fromLatin1( "/usr/share/xsessions/plasma.desktop" );
+    const QString kf5Config = KStandardDirs::findExe( "kf5-config" );
+    const QString dolphin = KStandardDirs::findExe( "dolphin" );
+
+    /* The versions only change with a package upgrade, which changes the
+       binaries or the desktop file. Qt may be upgraded alone, so kf5-config's
+       output is also considered stale after a reboot. */
+    const QString key = FactCache::fileKey( QStringList() << kf5Config << dolphin << plasmaDesktop, true );
+    FactCache::Values facts;
+    if ( !FactCache::lookup( "KDE", key, facts ) )
+    {
+        /* Grab KF5 & Qt5 info */
+        if ( !kf5Config.isEmpty() )
+        {
+            Q_FOREACH ( const QString & line, commandOutput( kf5Config + " --version" ) )
+            {
+                if (line.startsWith("Qt:")) {
+                    facts["Qt"] = line.section(':', 1, 1);
+                } else if (line.startsWith("KDE Frameworks:")) {
+                    facts["KF5"] = line.section(':', 1, 1);
+                }
+            }
+        }
+
+        /* Grab KDE Applications info */
+        if ( !dolphin.isEmpty() )
+        {
+            Q_FOREACH ( const QString & line, commandOutput( dolphin + " --version" ) )
+            {
+                if (line.startsWith("dolphin")) {
+                    facts["Apps"] = line.section(' ', 1, 1);
+                }
+            }
+        }
+
+        KDesktopFile desktopFile( plasmaDesktop );
+        facts["Plasma"] = desktopFile.desktopGroup().readEntry( "X-KDE-PluginInfo-Version", QString() );
+
+        FactCache::store( "KDE", key, facts );
+    }
+
+    setFact( info, SysInfoSnapshot::QT5_VERSION, facts, "Qt" );
+    setFact( info, SysInfoSnapshot::KF5_VERSION, facts, "KF5" );
+    setFact( info, SysInfoSnapshot::KDEAPPS_VERSION, facts, "Apps" );
+    setFact( info, SysInfoSnapshot::PLASMA_VERSION, facts, "Plasma" );
+    if ( !info.has( SysInfoSnapshot::PLASMA_VERSION ) )
+        info.setText( SysInfoSnapshot::PLASMA_VERSION, KDE::versionString() );
+
+    return true;
+}
+
+bool kio_sysinfoProtocol::waylandInfo( SysInfoSnapshot & info )
+{
+    const QString header = QString::fromLatin1( "/usr/include/wayland-version.h" );
+    const QString key = FactCache::fileKey( QStringList() << header );
+    FactCache::Values facts;
+    if ( !FactCache::lookup( "Wayland", key, facts ) )
+    {
+        if ( QFile::exists( header ) )
+            facts["Version"] = readFromFile( header, "#define WAYLAND_VERSION", "\"" );
+        FactCache::store( "Wayland", key, facts );
+    }
+
+    setFact( info, SysInfoSnapshot::WAYLAND_VER, facts, "Version" );
+    return info.has( SysInfoSnapshot::WAYLAND_VER );
+}
+
+bool kio_sysinfoProtocol::osInfo( SysInfoSnapshot & info )
+{
+    struct utsname uts;
+    uname( &uts );
+    info.setText( SysInfoSnapshot::OS_SYSNAME, uts.sysname, strlen( uts.sysname ) );
+    info.setText( SysInfoSnapshot::OS_RELEASE, uts.release, strlen( uts.release ) );
+    info.setText( SysInfoSnapshot::OS_VERSION, uts.version, strlen( uts.version ) );
+    info.setText( SysInfoSnapshot::OS_MACHINE, uts.machine, strlen( uts.machine ) );
+    info.setText( SysInfoSnapshot::OS_HOSTNAME, uts.nodename, strlen( uts.nodename ) );
+
+    /* left out when unknown, the page says so */
+    QString system;
+#ifdef WITH_FEDORA
+    system = readFromFile( "/etc/redhat-release" );
+#elif defined(WITH_SUSE)
+    system = readFromFile( "/etc/SuSE-release" );
+#elif defined(WITH_DEBIAN)
+    system = readFromFile( "/etc/debian_version" );
+#elif defined(WITH_UBUNTU)
+    system = readFromFile ( "/etc/os-release", "NAME", "=" ).remove(QChar('\"'), Qt::CaseInsensitive) + " " + readFromFile ( "/etc/os-release", "VERSION", "=" ).remove(QChar('\"'), Qt::CaseInsensitive);
+#endif
+    if ( !system.isEmpty() )
+        info.setText( SysInfoSnapshot::OS_SYSTEM, system.replace("X86-64", "x86_64") );
+
+    return true;
+}
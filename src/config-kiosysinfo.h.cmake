@@ -1,6 +1,7 @@
 /* stuff */
 #cmakedefine HAVE_HD 1
 #cmakedefine HAVE_GLXCHOOSEVISUAL 1
+#cmakedefine HAVE_EGL 1
 
 /* distros */
 #cmakedefine WITH_SUSE 1
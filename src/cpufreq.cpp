@@ -0,0 +1,136 @@
+//////////////////////////////////////////////////////////////////////////
+// cpufreq.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "cpufreq.h"
+#include "procfs.h"
+
+#include <QDataStream>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static QByteArray readAttribute( int dirfd, const char * name )
+{
+    char buffer[256];
+    const int length = ProcFS::readFileAt( dirfd, name, buffer, sizeof( buffer ) );
+    if ( length <= 0 )
+        return QByteArray();
+    return QByteArray( buffer, length ).trimmed();
+}
+
+static quint32 readKHz( int dirfd, const char * name )
+{
+    char buffer[32];
+    return ProcFS::readFileAt( dirfd, name, buffer, sizeof( buffer ) ) > 0 ? strtoul( buffer, 0, 10 ) : 0;
+}
+
+bool CpuFreq::read( const char * root )
+{
+    m_policies.clear();
+
+    DIR * dir = opendir( root );
+    if ( !dir )
+        return false;
+
+    char buffer[4096];
+    while ( struct dirent * entry = readdir( dir ) )
+    {
+        if ( strncmp( entry->d_name, "policy", 6 ) != 0 )
+            continue;
+        const int policyDir = ::openat( ::dirfd( dir ), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+        if ( policyDir < 0 )
+            continue;
+
+        CpuFreqPolicy policy;
+        const int length = ProcFS::readFileAt( policyDir, "affected_cpus", buffer, sizeof( buffer ) );
+        // a policy without CPUs belongs to CPUs which are offline
+        if ( length > 0 )
+        {
+            // affected_cpus is blank separated, turn it into a list
+            for ( int i = 0; i < length; ++i )
+            {
+                if ( buffer[i] == ' ' )
+                    buffer[i] = ',';
+            }
+            ProcFS::parseList( buffer, buffer + length, policy.cpus );
+        }
+        if ( !policy.cpus.isEmpty() )
+        {
+            policy.minKHz = readKHz( policyDir, "scaling_min_freq" );
+            policy.curKHz = readKHz( policyDir, "scaling_cur_freq" );
+            policy.maxKHz = readKHz( policyDir, "scaling_max_freq" );
+            policy.governor = readAttribute( policyDir, "scaling_governor" );
+            policy.preference = readAttribute( policyDir, "energy_performance_preference" );
+            m_policies.append( policy );
+        }
+        ::close( policyDir );
+    }
+    closedir( dir );
+
+    return !m_policies.isEmpty();
+}
+
+quint32 CpuFreq::averageKHz() const
+{
+    quint64 sum = 0;
+    int cpus = 0;
+    for ( int i = 0; i < m_policies.size(); ++i )
+    {
+        sum += quint64( m_policies.at( i ).curKHz ) * m_policies.at( i ).cpus.size();
+        cpus += m_policies.at( i ).cpus.size();
+    }
+    return cpus ? sum / cpus : 0;
+}
+
+const CpuFreqPolicy * CpuFreq::policyOf( int cpu ) const
+{
+    for ( int i = 0; i < m_policies.size(); ++i )
+    {
+        if ( m_policies.at( i ).cpus.contains( cpu ) )
+            return &m_policies.at( i );
+    }
+    return 0;
+}
+
+static QDataStream & operator<<( QDataStream & stream, const CpuFreqPolicy & policy )
+{
+    return stream << policy.cpus << policy.minKHz << policy.curKHz << policy.maxKHz
+                  << policy.governor << policy.preference;
+}
+
+static QDataStream & operator>>( QDataStream & stream, CpuFreqPolicy & policy )
+{
+    return stream >> policy.cpus >> policy.minKHz >> policy.curKHz >> policy.maxKHz
+                  >> policy.governor >> policy.preference;
+}
+
+QDataStream & operator<<( QDataStream & stream, const CpuFreq & freq )
+{
+    return stream << freq.m_policies;
+}
+
+QDataStream & operator>>( QDataStream & stream, CpuFreq & freq )
+{
+    return stream >> freq.m_policies;
+}
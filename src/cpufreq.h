@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////////////
+// cpufreq.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _cpufreq_H_
+#define _cpufreq_H_
+
+#include <qbytearray.h>
+#include <qvector.h>
+
+class QDataStream;
+
+/**
+ * One cpufreq policy, shared by all CPUs which switch frequency together
+ */
+struct CpuFreqPolicy
+{
+    QVector<int> cpus;      // affected_cpus
+    quint32 minKHz;         // scaling_min_freq
+    quint32 curKHz;         // scaling_cur_freq
+    quint32 maxKHz;         // scaling_max_freq
+    QByteArray governor;
+    QByteArray preference;  // energy_performance_preference, empty if n/a
+};
+
+/**
+ * Frequency scaling state from /sys/devices/system/cpu/cpufreq/policy*.
+ *
+ * Read per policy rather than per CPU, through the open policy directory.
+ */
+class CpuFreq
+{
+public:
+    /**
+     * Read all policies, replacing the previous contents
+     * @return false if there is no cpufreq support
+     */
+    bool read( const char * root = "/sys/devices/system/cpu/cpufreq" );
+
+    const QVector<CpuFreqPolicy> & policies() const { return m_policies; }
+
+    /**
+     * @return the current frequency averaged over all CPUs, in kHz
+     */
+    quint32 averageKHz() const;
+
+    /**
+     * @return the policy @p cpu belongs to, 0 if none
+     */
+    const CpuFreqPolicy * policyOf( int cpu ) const;
+
+    /**
+     * Stream the policies, e.g. from the sampler daemon to a slave
+     */
+    friend QDataStream & operator<<( QDataStream & stream, const CpuFreq & freq );
+    friend QDataStream & operator>>( QDataStream & stream, CpuFreq & freq );
+
+private:
+    QVector<CpuFreqPolicy> m_policies;
+};
+
+#endif
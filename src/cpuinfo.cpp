@@ -0,0 +1,158 @@
+//////////////////////////////////////////////////////////////////////////
+// cpuinfo.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "cpuinfo.h"
+#include "procfs.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static bool keyIs( const char * key, int length, const char * name )
+{
+    return int( strlen( name ) ) == length && memcmp( key, name, length ) == 0;
+}
+
+CpuInfoTable::CpuInfoTable()
+{
+}
+
+bool CpuInfoTable::read( const char * path )
+{
+    QByteArray data;
+    data.swap( m_buffer );  // reuse the previous allocation
+    if ( !ProcFS::readFile( path, data ) )
+    {
+        m_cpus.clear();
+        return false;
+    }
+    return parse( data );
+}
+
+bool CpuInfoTable::parse( const QByteArray & data )
+{
+    m_buffer = data;
+    m_cpus.clear();
+
+    const char * const begin = m_buffer.constData();
+    const char * const end = begin + m_buffer.size();
+    CpuInfoRecord * cpu = 0;
+
+    for ( const char * line = begin; line < end; )
+    {
+        const char * eol = static_cast<const char *>( memchr( line, '\n', end - line ) );
+        if ( !eol )
+            eol = end;
+
+        // "key<tabs>: value"
+        const char * colon = static_cast<const char *>( memchr( line, ':', eol - line ) );
+        if ( colon )
+        {
+            const char * keyEnd = colon;
+            while ( keyEnd > line && ( keyEnd[-1] == ' ' || keyEnd[-1] == '\t' ) )
+                --keyEnd;
+            const int keyLength = keyEnd - line;
+
+            const char * value = colon + 1;
+            while ( value < eol && ( *value == ' ' || *value == '\t' ) )
+                ++value;
+            const int valueLength = eol - value;
+
+            if ( keyIs( line, keyLength, "processor" ) )
+            {
+                CpuInfoRecord record;
+                record.processor = atoi( value );
+                record.physicalId = record.coreId = -1;
+                record.mhz = 0;
+                record.modelOffset = record.modelLength = 0;
+                record.flagsOffset = record.flagsLength = 0;
+                m_cpus.append( record );
+                cpu = &m_cpus.last();
+            }
+            else if ( cpu )
+            {
+                if ( keyIs( line, keyLength, "cpu MHz" ) || keyIs( line, keyLength, "clock" ) )
+                    cpu->mhz = ProcFS::toFloat( value, eol );   // stops at a trailing "MHz" on PPC
+                else if ( keyIs( line, keyLength, "model name" ) ||
+                          ( keyIs( line, keyLength, "cpu" ) && !cpu->modelLength ) )
+                {
+                    cpu->modelOffset = value - begin;
+                    cpu->modelLength = valueLength;
+                }
+                else if ( keyIs( line, keyLength, "physical id" ) )
+                    cpu->physicalId = atoi( value );
+                else if ( keyIs( line, keyLength, "core id" ) )
+                    cpu->coreId = atoi( value );
+                else if ( keyIs( line, keyLength, "flags" ) || keyIs( line, keyLength, "Features" ) )
+                {
+                    cpu->flagsOffset = value - begin;
+                    cpu->flagsLength = valueLength;
+                }
+            }
+        }
+
+        line = eol + 1;
+    }
+
+    return !m_cpus.isEmpty();
+}
+
+QByteArray CpuInfoTable::model( int cpu ) const
+{
+    const CpuInfoRecord & record = m_cpus.at( cpu );
+    return m_buffer.mid( record.modelOffset, record.modelLength );
+}
+
+QByteArray CpuInfoTable::flags( int cpu ) const
+{
+    const CpuInfoRecord & record = m_cpus.at( cpu );
+    return m_buffer.mid( record.flagsOffset, record.flagsLength );
+}
+
+bool CpuInfoTable::hasFlag( int cpu, const char * flag ) const
+{
+    const CpuInfoRecord & record = m_cpus.at( cpu );
+    const char * p = m_buffer.constData() + record.flagsOffset;
+    const char * const end = p + record.flagsLength;
+    const int length = strlen( flag );
+
+    while ( p < end )
+    {
+        const char * space = static_cast<const char *>( memchr( p, ' ', end - p ) );
+        if ( !space )
+            space = end;
+        if ( space - p == length && memcmp( p, flag, length ) == 0 )
+            return true;
+        p = space + 1;
+    }
+    return false;
+}
+
+int CpuInfoTable::packageCount() const
+{
+    QVector<int> seen;
+    for ( int i = 0; i < m_cpus.size(); ++i )
+    {
+        const int id = m_cpus.at( i ).physicalId;
+        if ( id >= 0 && !seen.contains( id ) )
+            seen.append( id );
+    }
+    return qMax( 1, seen.size() );
+}
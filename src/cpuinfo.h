@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////
+// cpuinfo.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _cpuinfo_H_
+#define _cpuinfo_H_
+
+#include <qbytearray.h>
+#include <qvector.h>
+
+/**
+ * One "processor" block of /proc/cpuinfo
+ *
+ * Strings are not copied out of the file, model and flags are byte ranges
+ * in the buffer owned by the CpuInfoTable.
+ */
+struct CpuInfoRecord
+{
+    int processor;
+    int physicalId;         // -1 if not reported
+    int coreId;             // -1 if not reported
+    float mhz;              // 0 if not reported
+    int modelOffset, modelLength;
+    int flagsOffset, flagsLength;
+};
+
+/**
+ * Per-CPU table filled from a single pass over /proc/cpuinfo
+ */
+class CpuInfoTable
+{
+public:
+    CpuInfoTable();
+
+    /**
+     * Read and parse @p path, replacing the previous contents
+     * @return false if the file can't be read or lists no CPU
+     */
+    bool read( const char * path = "/proc/cpuinfo" );
+
+    /**
+     * Parse cpuinfo formatted @p data, which the table keeps a reference to
+     */
+    bool parse( const QByteArray & data );
+
+    int count() const { return m_cpus.size(); }
+    const CpuInfoRecord & at( int cpu ) const { return m_cpus.at( cpu ); }
+
+    /**
+     * @return the model name of @p cpu ("model name", or "cpu" on PPC)
+     */
+    QByteArray model( int cpu ) const;
+
+    /**
+     * @return the space separated flags of @p cpu ("flags", or "Features" on ARM)
+     */
+    QByteArray flags( int cpu ) const;
+
+    bool hasFlag( int cpu, const char * flag ) const;
+
+    /**
+     * @return the number of distinct physical packages, 1 if not reported
+     */
+    int packageCount() const;
+
+private:
+    QByteArray m_buffer;
+    QVector<CpuInfoRecord> m_cpus;
+};
+
+#endif
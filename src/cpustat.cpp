@@ -0,0 +1,204 @@
+//////////////////////////////////////////////////////////////////////////
+// cpustat.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "cpustat.h"
+#include "procfs.h"
+
+#include <QDataStream>
+
+#include <string.h>
+
+// sanity limit for the CPU count of a streamed CpuStat
+#define MAX_STREAMED_CPUS 65536
+
+CpuStat::CpuStat( int history )
+    : m_history( qMax( history, 2 ) ), m_cpus( 0 ), m_head( 0 ), m_count( 0 )
+{
+    m_buffer.reserve( 16384 );
+}
+
+void CpuStat::reset( int cpus )
+{
+    m_cpus = cpus;
+    m_head = 0;
+    m_count = 0;
+    for ( int i = 0; i < STATE_COUNT; ++i )
+    {
+        m_ticks[i].resize( m_history * m_cpus );
+        m_ticks[i].fill( 0 );
+    }
+}
+
+/*
+ * "cpuN user nice system idle iowait irq softirq steal guest guest_nice",
+ * following the "cpu" line with the sums. Offline CPUs have no line.
+ */
+bool CpuStat::sample()
+{
+    if ( !ProcFS::readFile( "/proc/stat", m_buffer ) )
+        return false;
+
+    const char * const data = m_buffer.constData();
+    const char * const end = data + m_buffer.size();
+
+    // the CPU lines come first; find the highest CPU number to size the slots
+    const char * cpuEnd = data;
+    int cpus = 0;
+    ProcFS::Line line;
+    for ( const char * p = data; p && p < end; )
+    {
+        const char * next = ProcFS::nextLine( p, end, line );
+        if ( line.keyLength < 3 || strncmp( line.key, "cpu", 3 ) != 0 )
+            break;
+        if ( line.keyLength > 3 )
+            cpus = qMax( cpus, int( ProcFS::toULong( line.key + 3, line.key + line.keyLength ) ) + 1 );
+        cpuEnd = next ? next : end;
+        p = next;
+    }
+
+    if ( cpus != m_cpus )
+        reset( cpus );
+
+    const int slot = m_head;
+    const int base = slot * m_cpus;
+    for ( int i = 0; i < STATE_COUNT; ++i )
+        memset( m_ticks[i].data() + base, 0, m_cpus * sizeof( quint64 ) );
+
+    for ( const char * p = data; p && p < cpuEnd; )
+    {
+        p = ProcFS::nextLine( p, cpuEnd, line );
+        if ( line.keyLength <= 3 )
+            continue;   // the sums
+
+        const int cpu = base + ProcFS::toULong( line.key + 3, line.key + line.keyLength );
+        quint64 counters[8];
+        memset( counters, 0, sizeof( counters ) );
+        const char * v = line.value;
+        const char * word;
+        int length;
+        for ( int i = 0; i < 8 && ProcFS::nextWord( v, line.end, word, length ); ++i )
+            counters[i] = ProcFS::toULong( word, word + length );
+
+        m_ticks[User][cpu] = counters[0] + counters[1];
+        m_ticks[System][cpu] = counters[2] + counters[5] + counters[6];
+        m_ticks[Idle][cpu] = counters[3];
+        m_ticks[IoWait][cpu] = counters[4];
+        m_ticks[Steal][cpu] = counters[7];
+    }
+
+    m_head = ( m_head + 1 ) % m_history;
+    m_count = qMin( m_count + 1, m_history );
+    return true;
+}
+
+/**
+ * Ticks in @p state between slots @p then and @p now. The kernel's iowait and
+ * idle counters can go back a little on tickless systems, which counts as 0.
+ */
+quint64 CpuStat::spent( State state, int now, int then, int cpu ) const
+{
+    const quint64 before = ticks( state, then, cpu ), after = ticks( state, now, cpu );
+    return after > before ? after - before : 0;
+}
+
+/**
+ * Sum of the above over all states
+ */
+quint64 CpuStat::elapsed( int now, int then, int cpu ) const
+{
+    quint64 sum = 0;
+    for ( int i = 0; i < STATE_COUNT; ++i )
+        sum += spent( State( i ), now, then, cpu );
+    return sum;
+}
+
+bool CpuStat::online( int cpu, int interval ) const
+{
+    if ( interval >= intervalCount() )
+        return false;
+    const int now = slot( interval ), then = slot( interval + 1 );
+    // a CPU coming back online starts over, its counters don't move forward
+    quint64 before = 0;
+    for ( int i = 0; i < STATE_COUNT; ++i )
+        before += ticks( State( i ), then, cpu );
+    return before && elapsed( now, then, cpu );
+}
+
+float CpuStat::percent( int cpu, State state, int interval ) const
+{
+    if ( !online( cpu, interval ) )
+        return 0.0f;
+    const int now = slot( interval ), then = slot( interval + 1 );
+    return spent( state, now, then, cpu ) * 100.0f / elapsed( now, then, cpu );
+}
+
+float CpuStat::busy( int cpu, int interval ) const
+{
+    if ( !online( cpu, interval ) )
+        return 0.0f;
+    return 100.0f - percent( cpu, Idle, interval );
+}
+
+const char * CpuStat::stateName( State state )
+{
+    static const char * const names[STATE_COUNT] = { "user", "system", "iowait", "steal", "idle" };
+    return names[state];
+}
+
+QDataStream & operator<<( QDataStream & stream, const CpuStat & stat )
+{
+    const int count = qMin( stat.m_count, 2 );
+    stream << qint32( stat.m_cpus ) << qint32( count );
+    for ( int back = count - 1; back >= 0; --back )
+    {
+        for ( int i = 0; i < CpuStat::STATE_COUNT; ++i )
+        {
+            for ( int cpu = 0; cpu < stat.m_cpus; ++cpu )
+                stream << stat.ticks( CpuStat::State( i ), stat.slot( back ), cpu );
+        }
+    }
+    return stream;
+}
+
+QDataStream & operator>>( QDataStream & stream, CpuStat & stat )
+{
+    qint32 cpus, count;
+    stream >> cpus >> count;
+    if ( cpus < 0 || cpus > MAX_STREAMED_CPUS || count < 0 || count > 2 )
+    {
+        stream.setStatus( QDataStream::ReadCorruptData );
+        return stream;
+    }
+
+    stat.reset( cpus );
+    for ( int n = 0; n < count; ++n )
+    {
+        const int base = stat.m_head * cpus;
+        for ( int i = 0; i < CpuStat::STATE_COUNT; ++i )
+        {
+            for ( int cpu = 0; cpu < cpus; ++cpu )
+                stream >> stat.m_ticks[i][base + cpu];
+        }
+        stat.m_head = ( stat.m_head + 1 ) % stat.m_history;
+        ++stat.m_count;
+    }
+    return stream;
+}
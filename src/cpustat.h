@@ -0,0 +1,121 @@
+//////////////////////////////////////////////////////////////////////////
+// cpustat.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _cpustat_H_
+#define _cpustat_H_
+
+#include <qbytearray.h>
+#include <qvector.h>
+
+class QDataStream;
+
+/**
+ * Per-CPU time accounting sampled from /proc/stat.
+ *
+ * The counters are kept in a ring of the last few samples, laid out as a
+ * structure of arrays: one array per state, indexed by sample slot and CPU.
+ * Computing one state for all CPUs walks a contiguous range, and sampling
+ * a large box often neither allocates nor scatters over memory.
+ */
+class CpuStat
+{
+public:
+    /**
+     * CPU states, the kernel's ten counters folded into five
+     */
+    enum State
+    {
+        User = 0,       // user, nice (includes guest time)
+        System,         // system, irq, softirq
+        IoWait,
+        Steal,
+        Idle,
+        STATE_COUNT
+    };
+
+    /**
+     * @param history number of samples kept, at least 2
+     */
+    explicit CpuStat( int history = 16 );
+
+    /**
+     * Read /proc/stat into the next slot of the ring. The history is reset
+     * if the number of CPUs changed.
+     * @return false if the file couldn't be read
+     */
+    bool sample();
+
+    /**
+     * @return the number of CPU slots, offline CPUs included
+     */
+    int cpuCount() const { return m_cpus; }
+
+    /**
+     * @return the number of intervals there is data for, at most history - 1
+     */
+    int intervalCount() const { return m_count > 1 ? m_count - 1 : 0; }
+
+    /**
+     * @return the percentage of time @p cpu spent in @p state during an
+     * interval, 0 being the one between the last two samples.
+     * All states are 0 for a CPU which was offline.
+     */
+    float percent( int cpu, State state, int interval = 0 ) const;
+
+    /**
+     * @return the percentage of time @p cpu wasn't idle during @p interval,
+     * 0 if it was offline
+     */
+    float busy( int cpu, int interval = 0 ) const;
+
+    /**
+     * @return whether @p cpu accounted any time during @p interval
+     */
+    bool online( int cpu, int interval = 0 ) const;
+
+    /**
+     * @return the name of @p state as used in the JSON output
+     */
+    static const char * stateName( State state );
+
+    /**
+     * Stream the last two samples, which is what interval 0 needs, e.g.
+     * from the sampler daemon to a slave. Reading replaces the history.
+     */
+    friend QDataStream & operator<<( QDataStream & stream, const CpuStat & stat );
+    friend QDataStream & operator>>( QDataStream & stream, CpuStat & stat );
+
+private:
+    int slot( int back ) const { return ( m_head - 1 - back + 2 * m_history ) % m_history; }
+    quint64 ticks( State state, int slot, int cpu ) const { return m_ticks[state].at( slot * m_cpus + cpu ); }
+    quint64 spent( State state, int now, int then, int cpu ) const;
+    quint64 elapsed( int now, int then, int cpu ) const;
+    void reset( int cpus );
+
+    int m_history;
+    int m_cpus;
+    int m_head;         // slot the next sample goes to
+    int m_count;        // samples in the ring
+    QVector<quint64> m_ticks[STATE_COUNT];  // [slot * m_cpus + cpu]
+    QByteArray m_buffer;
+};
+
+#endif
@@ -0,0 +1,222 @@
+//////////////////////////////////////////////////////////////////////////
+// cputopology.cpp                                                      //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "cputopology.h"
+#include "procfs.h"
+
+#include <QMutex>
+#include <QSet>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @return the integer in sysfs attribute @p path below @p dirfd, or @p fallback
+ */
+static int readInt( int dirfd, const char * path, int fallback )
+{
+    char buffer[32];
+    if ( ProcFS::readFileAt( dirfd, path, buffer, sizeof( buffer ) ) <= 0 )
+        return fallback;
+    return atoi( buffer );
+}
+
+/**
+ * @return a cache size like "32K" in bytes
+ */
+static quint64 parseSize( const char * p )
+{
+    static const char units[] = "KMG";
+    const quint64 size = strtoull( p, const_cast<char **>( &p ), 10 );
+    const char * unit = *p ? strchr( units, *p ) : 0;
+    return unit ? size << ( 10 * ( unit - units + 1 ) ) : size;
+}
+
+static bool cpuLessThan( const CpuPlacement & a, const CpuPlacement & b )
+{
+    return a.cpu < b.cpu;
+}
+
+static bool cacheLessThan( const CpuCacheInfo & a, const CpuCacheInfo & b )
+{
+    return a.level < b.level || ( a.level == b.level && a.type < b.type );
+}
+
+CpuTopology::CpuTopology()
+    : m_packages( 0 ), m_cores( 0 ), m_nodes( 0 )
+{
+}
+
+bool CpuTopology::read( const char * root )
+{
+    m_cpus.clear();
+    m_caches.clear();
+    m_packages = m_cores = m_nodes = 0;
+
+    char path[256];
+    snprintf( path, sizeof( path ), "%s/cpu", root );
+    const int cpuDir = ::open( path, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if ( cpuDir < 0 )
+        return false;
+
+    // the readdir() stream takes over its own descriptor
+    DIR * dir = fdopendir( ::dup( cpuDir ) );
+    if ( dir )
+    {
+        while ( struct dirent * entry = readdir( dir ) )
+        {
+            if ( strncmp( entry->d_name, "cpu", 3 ) != 0 || entry->d_name[3] < '0' || entry->d_name[3] > '9' )
+                continue;
+
+            // offline CPUs have no topology
+            CpuPlacement placement;
+            placement.cpu = atoi( entry->d_name + 3 );
+            snprintf( path, sizeof( path ), "%s/topology/physical_package_id", entry->d_name );
+            placement.package = readInt( cpuDir, path, -1 );
+            if ( placement.package < 0 )
+                continue;
+            snprintf( path, sizeof( path ), "%s/topology/core_id", entry->d_name );
+            placement.core = readInt( cpuDir, path, placement.cpu );
+            placement.node = 0;
+            m_cpus.append( placement );
+        }
+        closedir( dir );
+    }
+
+    qSort( m_cpus.begin(), m_cpus.end(), cpuLessThan );
+
+    QSet<int> packages;
+    QSet<qint64> cores;
+    for ( int i = 0; i < m_cpus.size(); ++i )
+    {
+        packages.insert( m_cpus.at( i ).package );
+        cores.insert( ( qint64( m_cpus.at( i ).package ) << 32 ) | quint32( m_cpus.at( i ).core ) );
+        readCaches( cpuDir, m_cpus.at( i ).cpu );
+    }
+    m_packages = packages.size();
+    m_cores = cores.size();
+    ::close( cpuDir );
+    qSort( m_caches.begin(), m_caches.end(), cacheLessThan );
+
+    // NUMA nodes, from each node's CPU list
+    snprintf( path, sizeof( path ), "%s/node", root );
+    const int nodeDir = ::open( path, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    char buffer[4096];
+    QVector<int> nodes, cpus;
+    int length;
+    if ( nodeDir >= 0 && ( length = ProcFS::readFileAt( nodeDir, "online", buffer, sizeof( buffer ) ) ) > 0 &&
+         ProcFS::parseList( buffer, buffer + length, nodes ) )
+    {
+        m_nodes = nodes.size();
+        Q_FOREACH ( int node, nodes )
+        {
+            snprintf( path, sizeof( path ), "node%d/cpulist", node );
+            length = ProcFS::readFileAt( nodeDir, path, buffer, sizeof( buffer ) );
+            if ( length <= 0 || !ProcFS::parseList( buffer, buffer + length, cpus ) )
+                continue;
+            for ( int i = 0; i < m_cpus.size(); ++i )
+            {
+                if ( cpus.contains( m_cpus.at( i ).cpu ) )
+                    m_cpus[i].node = node;
+            }
+        }
+    }
+    else
+        m_nodes = 1;
+    if ( nodeDir >= 0 )
+        ::close( nodeDir );
+
+    return !m_cpus.isEmpty();
+}
+
+/*
+ * A cache instance is read through the lowest numbered CPU sharing it,
+ * the others only read shared_cpu_list to find out they're not that CPU.
+ */
+void CpuTopology::readCaches( int cpuDir, int cpu )
+{
+    char path[128];
+    char buffer[1024];
+    QVector<int> shared;
+
+    for ( int index = 0; ; ++index )
+    {
+        snprintf( path, sizeof( path ), "cpu%d/cache/index%d/shared_cpu_list", cpu, index );
+        const int length = ProcFS::readFileAt( cpuDir, path, buffer, sizeof( buffer ) );
+        if ( length < 0 )
+            break;
+        if ( !ProcFS::parseList( buffer, buffer + length, shared ) || shared.isEmpty() || shared.first() != cpu )
+            continue;
+
+        CpuCacheInfo cache;
+        snprintf( path, sizeof( path ), "cpu%d/cache/index%d/level", cpu, index );
+        cache.level = readInt( cpuDir, path, 0 );
+        snprintf( path, sizeof( path ), "cpu%d/cache/index%d/type", cpu, index );
+        cache.type = ProcFS::readFileAt( cpuDir, path, buffer, sizeof( buffer ) ) > 0 ? buffer[0] | 0x20 : 'u';
+        snprintf( path, sizeof( path ), "cpu%d/cache/index%d/size", cpu, index );
+        cache.size = ProcFS::readFileAt( cpuDir, path, buffer, sizeof( buffer ) ) > 0 ? parseSize( buffer ) : 0;
+        cache.sharedBy = shared.size();
+        cache.instances = 1;
+
+        bool known = false;
+        for ( int i = 0; i < m_caches.size(); ++i )
+        {
+            CpuCacheInfo & other = m_caches[i];
+            if ( other.level == cache.level && other.type == cache.type && other.size == cache.size )
+            {
+                ++other.instances;
+                known = true;
+                break;
+            }
+        }
+        if ( !known )
+            m_caches.append( cache );
+    }
+}
+
+int CpuTopology::nodeOf( int cpu ) const
+{
+    for ( int i = 0; i < m_cpus.size(); ++i )
+    {
+        if ( m_cpus.at( i ).cpu == cpu )
+            return m_cpus.at( i ).node;
+    }
+    return -1;
+}
+
+const CpuTopology & CpuTopology::system()
+{
+    static QMutex mutex;
+    static CpuTopology topology;
+    static bool done = false;
+
+    QMutexLocker locker( &mutex );
+    if ( !done )
+    {
+        topology.read();
+        done = true;
+    }
+    return topology;
+}
@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////
+// cputopology.h                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _cputopology_H_
+#define _cputopology_H_
+
+#include <qvector.h>
+
+/**
+ * One kind of CPU cache, e.g. all the L2 caches
+ */
+struct CpuCacheInfo
+{
+    int level;
+    char type;              // 'd'ata, 'i'nstruction or 'u'nified
+    quint64 size;           // of one instance, in bytes
+    int instances;          // number of caches of this kind
+    int sharedBy;           // number of CPUs sharing one of them
+};
+
+/**
+ * Where a single online CPU sits
+ */
+struct CpuPlacement
+{
+    int cpu;
+    int package;            // physical_package_id
+    int core;               // core_id, unique within the package
+    int node;               // NUMA node, 0 without NUMA
+};
+
+/**
+ * Sockets, NUMA nodes, cores, SMT siblings and caches from sysfs
+ * (/sys/devices/system/cpu and /sys/devices/system/node).
+ *
+ * The attributes are read relative to an open directory with openat(),
+ * and cache attributes only once per cache instance rather than per CPU.
+ */
+class CpuTopology
+{
+public:
+    CpuTopology();
+
+    /**
+     * Read the topology below @p root, replacing the previous contents
+     * @return false if no CPU reported one
+     */
+    bool read( const char * root = "/sys/devices/system" );
+
+    /**
+     * @return the topology of this machine, read on first use and kept for
+     * the lifetime of the process. Thread safe.
+     */
+    static const CpuTopology & system();
+
+    int cpuCount() const { return m_cpus.size(); }
+    int packageCount() const { return m_packages; }
+    int coreCount() const { return m_cores; }
+    int nodeCount() const { return m_nodes; }
+
+    /**
+     * @return the number of SMT siblings per core
+     */
+    int threadsPerCore() const { return m_cores ? m_cpus.size() / m_cores : 1; }
+
+    /**
+     * @return the online CPUs, ordered by CPU number
+     */
+    const QVector<CpuPlacement> & cpus() const { return m_cpus; }
+
+    /**
+     * @return the kinds of cache, ordered by level and type
+     */
+    const QVector<CpuCacheInfo> & caches() const { return m_caches; }
+
+    /**
+     * @return the NUMA node of @p cpu, -1 if it's not online
+     */
+    int nodeOf( int cpu ) const;
+
+private:
+    void readCaches( int cpuDir, int cpu );
+
+    QVector<CpuPlacement> m_cpus;
+    QVector<CpuCacheInfo> m_caches;
+    int m_packages, m_cores, m_nodes;
+};
+
+#endif
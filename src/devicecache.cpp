@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////
+// devicecache.cpp                                                      //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "devicecache.h"
+
+#include <kdebug.h>
+
+#include <solid/block.h>
+#include <solid/device.h>
+#include <solid/devicenotifier.h>
+#include <solid/opticaldisc.h>
+#include <solid/storageaccess.h>
+#include <solid/storagedrive.h>
+#include <solid/storagevolume.h>
+
+DeviceCache::DeviceCache( const Solid::Predicate & predicate, QObject * parent )
+    : QObject( parent ), m_predicate( predicate ), m_changed( true )
+{
+    connect( Solid::DeviceNotifier::instance(), SIGNAL(deviceAdded(const QString &)),
+             this, SLOT(deviceAdded(const QString &)) );
+    connect( Solid::DeviceNotifier::instance(), SIGNAL(deviceRemoved(const QString &)),
+             this, SLOT(deviceRemoved(const QString &)) );
+
+    Q_FOREACH ( const Solid::Device & device, Solid::Device::listFromQuery( m_predicate ) )
+        add( device );
+}
+
+void DeviceCache::add( const Solid::Device & device )
+{
+    if ( !device.isValid() )
+        return;
+
+    const Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
+    const Solid::StorageVolume *volume = device.as<Solid::StorageVolume>();
+    const Solid::Block *block = device.as<Solid::Block>();
+    const Solid::StorageDrive *drive = device.parent().as<Solid::StorageDrive>();
+
+    DeviceEntry entry;
+    entry.udi = device.udi();
+    if ( block )
+        entry.deviceNode = block->device();
+    entry.size = 0;
+    if ( volume )
+    {
+        entry.fsType = volume->fsType();
+        entry.label = volume->label();
+        entry.size = volume->size();
+    }
+    entry.iconName = device.icon();
+    entry.accessible = access && access->isAccessible();
+    if ( entry.accessible )
+        entry.filePath = access->filePath();
+    entry.opticalDisc = device.is<Solid::OpticalDisc>();
+    entry.removableDrive = drive && drive->isRemovable();
+
+    if ( access && !m_devices.contains( entry.udi ) )
+        connect( access, SIGNAL(accessibilityChanged(bool, const QString &)),
+                 this, SLOT(accessibilityChanged(bool, const QString &)) );
+
+    m_devices.insert( entry.udi, entry );
+    m_changed = true;
+}
+
+bool DeviceCache::takeChanged()
+{
+    const bool changed = m_changed;
+    m_changed = false;
+    return changed;
+}
+
+void DeviceCache::deviceAdded( const QString & udi )
+{
+    const Solid::Device device( udi );
+    if ( m_predicate.matches( device ) )
+    {
+        kDebug(1242) << "Device added" << udi;
+        add( device );
+    }
+}
+
+void DeviceCache::deviceRemoved( const QString & udi )
+{
+    if ( m_devices.remove( udi ) )
+    {
+        kDebug(1242) << "Device removed" << udi;
+        m_changed = true;
+    }
+}
+
+void DeviceCache::accessibilityChanged( bool accessible, const QString & udi )
+{
+    const QMap<QString, DeviceEntry>::Iterator it = m_devices.find( udi );
+    if ( it == m_devices.end() )
+        return;
+
+    it->accessible = accessible;
+    m_changed = true;
+    it->filePath.clear();
+    if ( accessible )
+    {
+        const Solid::Device device( udi );
+        if ( const Solid::StorageAccess * access = device.as<Solid::StorageAccess>() )
+            it->filePath = access->filePath();
+    }
+}
+
+#include "devicecache.moc"
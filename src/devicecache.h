@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////
+// devicecache.h                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _devicecache_H_
+#define _devicecache_H_
+
+#include <qmap.h>
+#include <qobject.h>
+#include <qstring.h>
+
+#include <solid/predicate.h>
+
+namespace Solid
+{
+    class Device;
+}
+
+/**
+ * What the disk list needs to know about a Solid device
+ */
+struct DeviceEntry
+{
+    QString udi;
+    QString deviceNode;
+    QString fsType;
+    QString label;          // volume label, may be empty
+    QString iconName;
+    QString filePath;       // mount point while accessible
+    quint64 size;           // volume size in bytes
+    bool accessible;
+    bool opticalDisc;
+    bool removableDrive;    // the parent drive is removable
+};
+
+/**
+ * In-memory table of the storage devices matching a predicate.
+ *
+ * Enumerated once, then kept up to date from the DeviceNotifier and
+ * StorageAccess signals, so a page request reads the table instead of
+ * asking the backend about every device again. The slave doesn't run an
+ * event loop, pending signals are delivered by calling
+ * QCoreApplication::processEvents() before reading.
+ */
+class DeviceCache : public QObject
+{
+    Q_OBJECT
+public:
+    explicit DeviceCache( const Solid::Predicate & predicate, QObject * parent = 0 );
+
+    /**
+     * @return the matching devices by UDI
+     */
+    const QMap<QString, DeviceEntry> & devices() const { return m_devices; }
+
+    /**
+     * @return true if a device was added, removed or (un)mounted since the
+     * last call, or this is the first one
+     */
+    bool takeChanged();
+
+private Q_SLOTS:
+    void deviceAdded( const QString & udi );
+    void deviceRemoved( const QString & udi );
+    void accessibilityChanged( bool accessible, const QString & udi );
+
+private:
+    void add( const Solid::Device & device );
+
+    Solid::Predicate m_predicate;
+    QMap<QString, DeviceEntry> m_devices;
+    bool m_changed;
+};
+
+#endif
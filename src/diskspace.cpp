@@ -0,0 +1,205 @@
+//////////////////////////////////////////////////////////////////////////
+// diskspace.cpp                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "diskspace.h"
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QTime>
+#include <QWaitCondition>
+
+#include <kdebug.h>
+
+#include <sys/vfs.h>
+#include <time.h>
+#include <unistd.h>
+
+// at most this many statfs() calls run at once, not counting the hung ones
+#define DISKSPACE_THREADS 4
+
+/**
+ * One statfs() call on the pool. A call which missed its deadline keeps
+ * running on its own and is counted as hung until it returns.
+ */
+struct StatfsCall
+{
+    StatfsCall()
+        : startedAt( -1 ), done( false ), ok( false ), hung( false ), total( 0 ), avail( 0 ) {}
+
+    qint64 startedAt;       // monotonic ms, -1 while queued
+    bool done;
+    bool ok;
+    bool hung;
+    quint64 total, avail;
+};
+
+typedef QSharedPointer<StatfsCall> StatfsCallPtr;
+
+// all of the below and the calls are guarded by s_mutex
+static QMutex s_mutex;
+static QWaitCondition s_finished;               // a call started or returned
+static QHash<QString, StatfsCallPtr> s_calls;   // mount point -> call in flight
+static QHash<QString, qint64> s_deadUntil;      // mount point -> monotonic seconds
+static int s_hung = 0;
+
+static qint64 monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return qint64( ts.tv_sec ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static QThreadPool * pool()
+{
+    // leaked on purpose, ~QThreadPool() would wait for hung calls
+    static QThreadPool * pool = 0;
+    if ( !pool )
+    {
+        pool = new QThreadPool;
+        pool->setMaxThreadCount( DISKSPACE_THREADS );
+    }
+    return pool;
+}
+
+/**
+ * Account for a call starting or stopping to hang. The pool grows by one
+ * thread per hung call so that the healthy mounts queued behind them still
+ * get their turn; there can't be more hung calls than mount points, as a
+ * mount isn't asked again while its call is in flight.
+ */
+static void setHung( StatfsCall & call, bool hung )
+{
+    if ( call.hung == hung )
+        return;
+    call.hung = hung;
+    s_hung += hung ? 1 : -1;
+    pool()->setMaxThreadCount( DISKSPACE_THREADS + s_hung );
+}
+
+class StatfsTask : public QRunnable
+{
+public:
+    StatfsTask( const StatfsCallPtr & call, const QString & mountPoint )
+        : m_call( call ), m_mountPoint( mountPoint ) {}
+
+    void run()
+    {
+        {
+            QMutexLocker locker( &s_mutex );
+            m_call->startedAt = monotonicMs();
+            s_finished.wakeAll();
+        }
+
+        struct statfs sfs;
+        const bool ok = statfs( QFile::encodeName( m_mountPoint ), &sfs ) == 0;
+
+        QMutexLocker locker( &s_mutex );
+        if ( ok )
+        {
+            m_call->total = ( unsigned long long )sfs.f_blocks * sfs.f_bsize;
+            m_call->avail = ( unsigned long long )( getuid() ? sfs.f_bavail : sfs.f_bfree ) * sfs.f_bsize;
+        }
+        m_call->ok = ok;
+        m_call->done = true;
+        setHung( *m_call, false );
+        s_calls.remove( m_mountPoint );
+        s_finished.wakeAll();
+    }
+
+private:
+    StatfsCallPtr m_call;
+    QString m_mountPoint;
+};
+
+void DiskSpace::query( QVector<Request> & requests, int timeout, int retryInterval )
+{
+    QVector<StatfsCallPtr> calls( requests.size() );
+
+    QMutexLocker locker( &s_mutex );
+    const qint64 now = monotonicMs() / 1000;
+    for ( int i = 0; i < requests.size(); ++i )
+    {
+        const QString & mountPoint = requests.at( i ).mountPoint;
+        QHash<QString, qint64>::Iterator dead = s_deadUntil.find( mountPoint );
+        if ( dead != s_deadUntil.end() && dead.value() <= now )
+        {
+            s_deadUntil.erase( dead );
+            dead = s_deadUntil.end();
+        }
+        if ( dead != s_deadUntil.end() )
+        {
+            kDebug(1242) << "Skipping unresponsive mount" << mountPoint;
+            requests[i].state = Unresponsive;
+            continue;
+        }
+        // another caller's statfs() on it is still running, share its result
+        calls[i] = s_calls.value( mountPoint );
+        if ( calls.at( i ) )
+            continue;
+        calls[i] = StatfsCallPtr( new StatfsCall );
+        s_calls.insert( mountPoint, calls.at( i ) );
+        pool()->start( new StatfsTask( calls.at( i ), mountPoint ) );
+    }
+
+    // each call gets its own deadline from the time it started, one which
+    // is still queued behind others is waited for
+    for ( int i = 0; i < requests.size(); ++i )
+    {
+        StatfsCall * call = calls.at( i ).data();
+        if ( !call )
+            continue;
+
+        while ( !call->done )
+        {
+            if ( call->startedAt < 0 )
+            {
+                s_finished.wait( &s_mutex );
+                continue;
+            }
+            const qint64 remaining = call->startedAt + timeout - monotonicMs();
+            if ( remaining <= 0 || !s_finished.wait( &s_mutex, remaining ) )
+            {
+                if ( call->done || call->startedAt + timeout > monotonicMs() )
+                    continue;
+                kDebug(1242) << "statfs() on" << requests.at( i ).mountPoint << "missed the deadline of" << timeout << "ms";
+                setHung( *call, true );
+                s_deadUntil.insert( requests.at( i ).mountPoint, monotonicMs() / 1000 + retryInterval );
+                break;
+            }
+        }
+
+        Request & request = requests[i];
+        if ( !call->done )
+            request.state = Unresponsive;
+        else if ( call->ok )
+        {
+            request.total = call->total;
+            request.avail = call->avail;
+            request.state = Ok;
+        }
+        else
+            request.state = Failed;
+    }
+}
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////////////
+// diskspace.h                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _diskspace_H_
+#define _diskspace_H_
+
+#include <qstring.h>
+#include <qvector.h>
+
+// defaults for [Disks] StatfsTimeout (ms) and UnresponsiveRetryInterval (s)
+// in kio_sysinforc: how long to wait for statfs() on a mount, and for how
+// long a mount which didn't answer is not asked again
+#define DISKSPACE_TIMEOUT_MS 2000
+#define DISKSPACE_RETRY_S 300
+
+/**
+ * statfs() for a set of mount points, done in parallel on a small worker
+ * pool so that one hung network or FUSE mount can't stall the page.
+ *
+ * Each call gets a deadline from the time it starts; a mount which misses it
+ * is reported as unresponsive and remembered as dead for a while, during
+ * which it isn't asked again. A mount whose statfs() is still running for
+ * another caller isn't asked twice, its call is waited for with the same
+ * deadline. Hung calls don't count against the size of the pool.
+ * All functions are thread safe.
+ */
+namespace DiskSpace
+{
+    enum State
+    {
+        Ok = 0,
+        Failed,         // statfs() returned an error
+        Unresponsive    // missed the deadline, or known to be dead
+    };
+
+    struct Request
+    {
+        QString mountPoint;
+        quint64 total, avail;   // in bytes, untouched unless state is Ok
+        State state;
+    };
+
+    /**
+     * Fill in the space of every request in @p requests, waiting at most
+     * @p timeout ms for each once its statfs() started. Mounts which miss
+     * the deadline are skipped for @p retryInterval seconds.
+     */
+    void query( QVector<Request> & requests, int timeout, int retryInterval );
+}
+
+#endif
@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////////
+// diskstats.cpp                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "diskstats.h"
+#include "procfs.h"
+
+#include <string.h>
+#include <time.h>
+
+// diskstats counts in 512 byte sectors, whatever the device's sector size
+#define SECTOR_SIZE 512
+
+static qint64 monotonicMSecs()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return qint64( ts.tv_sec ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+DiskStats::DiskStats()
+    : m_currentTime( 0 ), m_previousTime( 0 )
+{
+    m_buffer.reserve( 16384 );
+    m_current.reserve( 64 );
+    m_previous.reserve( 64 );
+}
+
+bool DiskStats::sample()
+{
+    if ( !ProcFS::readFile( "/proc/diskstats", m_buffer ) )
+        return false;
+
+    // swapping only shuffles the shared data pointers, nothing is copied
+    qSwap( m_current, m_previous );
+    m_previousTime = m_currentTime;
+    m_currentTime = monotonicMSecs();
+    parse();
+    return true;
+}
+
+/*
+ * "major minor name reads merged sectors ms writes merged sectors ms
+ * in-flight io-ms weighted-ms [discard and flush fields]"
+ */
+void DiskStats::parse()
+{
+    const char * p = m_buffer.constData();
+    const char * const end = p + m_buffer.size();
+    int count = 0;
+
+    while ( p < end )
+    {
+        const char * eol = static_cast<const char *>( memchr( p, '\n', end - p ) );
+        if ( !eol )
+            eol = end;
+
+        // the device name (field 2) is not needed
+        quint64 fields[14];
+        int n = 0;
+        const char * word;
+        int length;
+        while ( n < 14 && ProcFS::nextWord( p, eol, word, length ) )
+        {
+            fields[n] = n == 2 ? 0 : ProcFS::toULong( word, word + length );
+            ++n;
+        }
+        p = eol + 1;
+
+        if ( n < 14 )
+            continue;
+
+        Record record;
+        record.major = fields[0];
+        record.minor = fields[1];
+        record.reads = fields[3];
+        record.readSectors = fields[5];
+        record.readTicks = fields[6];
+        record.writes = fields[7];
+        record.writeSectors = fields[9];
+        record.writeTicks = fields[10];
+        record.ioTicks = fields[12];
+        record.weightedTicks = fields[13];
+
+        if ( count < m_current.size() )
+            m_current[count] = record;
+        else
+            m_current.append( record );
+        ++count;
+    }
+
+    m_current.resize( count );
+}
+
+int DiskStats::find( const QVector<Record> & records, quint32 major, quint32 minor, int hint )
+{
+    // the table rarely changes, so the device is usually at the same index
+    if ( hint >= 0 && hint < records.size() &&
+         records.at( hint ).major == major && records.at( hint ).minor == minor )
+        return hint;
+
+    for ( int i = 0; i < records.size(); ++i )
+    {
+        if ( records.at( i ).major == major && records.at( i ).minor == minor )
+            return i;
+    }
+    return -1;
+}
+
+DiskIoRates DiskStats::rates( quint32 major, quint32 minor ) const
+{
+    DiskIoRates rates;
+    memset( &rates, 0, sizeof( rates ) );
+
+    const qint64 elapsed = m_currentTime - m_previousTime;
+    if ( !m_previousTime || elapsed <= 0 )
+        return rates;
+
+    const int current = find( m_current, major, minor, -1 );
+    const int previous = current < 0 ? -1 : find( m_previous, major, minor, current );
+    if ( previous < 0 )
+        return rates;
+
+    const Record & now = m_current.at( current );
+    const Record & then = m_previous.at( previous );
+
+    // a counter which went back means the device was replaced under the same
+    // number, or the counter wrapped: there is no telling what happened since
+    if ( now.reads < then.reads || now.readSectors < then.readSectors || now.readTicks < then.readTicks ||
+         now.writes < then.writes || now.writeSectors < then.writeSectors || now.writeTicks < then.writeTicks ||
+         now.ioTicks < then.ioTicks || now.weightedTicks < then.weightedTicks )
+        return rates;
+
+    const double seconds = elapsed / 1000.0;
+    const quint64 ios = ( now.reads - then.reads ) + ( now.writes - then.writes );
+
+    rates.valid = true;
+    rates.readBytes = ( now.readSectors - then.readSectors ) * double( SECTOR_SIZE ) / seconds;
+    rates.writeBytes = ( now.writeSectors - then.writeSectors ) * double( SECTOR_SIZE ) / seconds;
+    rates.readOps = ( now.reads - then.reads ) / seconds;
+    rates.writeOps = ( now.writes - then.writes ) / seconds;
+    rates.queueDepth = double( now.weightedTicks - then.weightedTicks ) / elapsed;
+    rates.serviceTime = ios ? double( now.ioTicks - then.ioTicks ) / ios : 0.0;
+    rates.utilization = qMin( 100.0, ( now.ioTicks - then.ioTicks ) * 100.0 / elapsed );
+    return rates;
+}
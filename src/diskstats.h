@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////
+// diskstats.h                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _diskstats_H_
+#define _diskstats_H_
+
+#include <qbytearray.h>
+#include <qvector.h>
+
+/**
+ * I/O activity of a block device between two samples
+ */
+struct DiskIoRates
+{
+    bool valid;             // false until there are two comparable samples
+    double readBytes;       // per second
+    double writeBytes;      // per second
+    double readOps;         // per second
+    double writeOps;        // per second
+    double queueDepth;      // average number of requests in flight
+    double serviceTime;     // average ms the device was busy per request
+    double utilization;     // percentage of the time the device was busy
+};
+
+/**
+ * Sampler for /proc/diskstats.
+ *
+ * Every sample() replaces the older of two samples, rates are computed
+ * between them. Kept alive by the slave, so the interval is the time since
+ * the previous page load and nothing has to sleep. After the first sample
+ * the buffers are reused and parsing doesn't allocate.
+ */
+class DiskStats
+{
+public:
+    DiskStats();
+
+    /**
+     * Read /proc/diskstats, the current sample becomes the previous one
+     * @return false if the file couldn't be read
+     */
+    bool sample();
+
+    /**
+     * @return the activity of device @p major:@p minor between the last
+     * two samples, not valid if it wasn't in both or one of its counters
+     * went back
+     */
+    DiskIoRates rates( quint32 major, quint32 minor ) const;
+
+private:
+    struct Record
+    {
+        quint32 major, minor;
+        quint64 reads, readSectors, readTicks;
+        quint64 writes, writeSectors, writeTicks;
+        quint64 ioTicks, weightedTicks;
+    };
+
+    void parse();
+    static int find( const QVector<Record> & records, quint32 major, quint32 minor, int hint );
+
+    QByteArray m_buffer;
+    QVector<Record> m_current, m_previous;
+    qint64 m_currentTime, m_previousTime;   // monotonic, in ms
+};
+
+#endif
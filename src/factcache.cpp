@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////
+// factcache.cpp                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "factcache.h"
+#include "procfs.h"
+
+#include <QFile>
+#include <QMutex>
+
+#include <kconfig.h>
+#include <kconfiggroup.h>
+#include <kstandarddirs.h>
+
+#include <sys/stat.h>
+
+// bump whenever the stored facts change meaning
+#define FACTCACHE_VERSION 1
+
+#define FACTCACHE_KEY "X-Sysinfo-Key"
+
+static QMutex s_mutex;
+
+static KConfig * cacheConfig()
+{
+    static KConfig * config = 0;
+    if ( !config )
+    {
+        config = new KConfig( KStandardDirs::locateLocal( "cache", "kio_sysinfo/facts" ),
+                              KConfig::SimpleConfig );
+        KConfigGroup general( config, "General" );
+        if ( general.readEntry( "Version", 0 ) != FACTCACHE_VERSION )
+        {
+            Q_FOREACH ( const QString & group, config->groupList() )
+                config->deleteGroup( group );
+            general.writeEntry( "Version", FACTCACHE_VERSION );
+            config->sync();
+        }
+    }
+    return config;
+}
+
+static QString bootId()
+{
+    static QString id;
+    if ( id.isNull() )
+    {
+        char buffer[64];
+        if ( ProcFS::readFile( "/proc/sys/kernel/random/boot_id", buffer, sizeof( buffer ) ) > 0 )
+            id = QString::fromLatin1( buffer ).trimmed();
+        else
+            id = QString::fromLatin1( "" );
+    }
+    return id;
+}
+
+QString FactCache::fileKey( const QStringList & files, bool perBoot )
+{
+    QStringList parts;
+    Q_FOREACH ( const QString & file, files )
+    {
+        struct stat st;
+        if ( file.isEmpty() || stat( QFile::encodeName( file ), &st ) != 0 )
+            parts << QString::fromLatin1( "-" );
+        else
+            parts << QString::fromLatin1( "%1:%2:%3:%4" ).arg( file ).arg( quint64( st.st_ino ) )
+                                                       .arg( quint64( st.st_size ) ).arg( qint64( st.st_mtime ) );
+    }
+
+    if ( perBoot )
+    {
+        QMutexLocker locker( &s_mutex );
+        parts << bootId();
+    }
+
+    return parts.join( QString::fromLatin1( ";" ) );
+}
+
+bool FactCache::lookup( const QString & fact, const QString & key, Values & values )
+{
+    QMutexLocker locker( &s_mutex );
+    const KConfigGroup group( cacheConfig(), fact );
+    if ( !group.exists() || group.readEntry( FACTCACHE_KEY, QString() ) != key )
+        return false;
+
+    values = group.entryMap();
+    values.remove( QString::fromLatin1( FACTCACHE_KEY ) );
+    return true;
+}
+
+void FactCache::store( const QString & fact, const QString & key, const Values & values )
+{
+    QMutexLocker locker( &s_mutex );
+    KConfigGroup group( cacheConfig(), fact );
+    group.deleteGroup();
+    for ( Values::ConstIterator it = values.constBegin(); it != values.constEnd(); ++it )
+        group.writeEntry( it.key(), it.value() );
+    group.writeEntry( FACTCACHE_KEY, key );
+    group.sync();
+}
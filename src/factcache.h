@@ -0,0 +1,61 @@
+//////////////////////////////////////////////////////////////////////////
+// factcache.h                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _factcache_H_
+#define _factcache_H_
+
+#include <qmap.h>
+#include <qstringlist.h>
+
+/**
+ * Persistent cache for facts which only change with a reboot or a package
+ * upgrade, like the versions reported by "kf5-config --version".
+ *
+ * Every fact is stored along with its invalidation key, built from the
+ * inputs it was derived from (see fileKey()). A lookup only hits if the
+ * key still matches, so a warm page load doesn't fork anything.
+ *
+ * The cache lives in $KDEHOME/cache-$HOST/kio_sysinfo/facts and is thrown
+ * away whenever its format version changes. All methods are thread safe.
+ */
+namespace FactCache
+{
+    typedef QMap<QString, QString> Values;
+
+    /**
+     * @return an invalidation key from inode, size and mtime of @p files,
+     * and from the current boot id if @p perBoot is set
+     */
+    QString fileKey( const QStringList & files, bool perBoot = false );
+
+    /**
+     * Look up @p fact, which has to have been stored with @p key
+     * @return false on a miss, @p values is left untouched then
+     */
+    bool lookup( const QString & fact, const QString & key, Values & values );
+
+    /**
+     * Store @p values for @p fact under @p key, replacing an older entry
+     */
+    void store( const QString & fact, const QString & key, const Values & values );
+}
+
+#endif
@@ -0,0 +1,321 @@
+//////////////////////////////////////////////////////////////////////////
+// glquery.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "glquery.h"
+#include "procfs.h"
+
+#include <config-kiosysinfo.h>
+
+#include <dirent.h>
+#include <dlfcn.h>
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <unistd.h>
+
+#ifdef HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#ifdef HAVE_GLXCHOOSEVISUAL
+#include <GL/glx.h>
+#endif
+
+#ifndef GL_VENDOR
+#define GL_VENDOR   0x1F00
+#define GL_RENDERER 0x1F01
+#define GL_VERSION  0x1F02
+#endif
+
+#ifdef HAVE_EGL
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+#ifndef EGL_NO_CONFIG_KHR
+#define EGL_NO_CONFIG_KHR ((EGLConfig)0)
+#endif
+
+typedef const unsigned char * (*GetStringFunc)( unsigned int name );
+typedef EGLDisplay (*GetPlatformDisplayFunc)( EGLenum platform, void * nativeDisplay, const EGLint * attribs );
+
+static bool hasExtension( const char * extensions, const char * name )
+{
+    if ( !extensions )
+        return false;
+    const int length = strlen( name );
+    for ( const char * p = extensions; ( p = strstr( p, name ) ); p += length )
+    {
+        if ( ( p == extensions || p[-1] == ' ' ) && ( p[length] == ' ' || p[length] == '\0' ) )
+            return true;
+    }
+    return false;
+}
+
+static EGLDisplay surfacelessDisplay()
+{
+    const char * clientExtensions = eglQueryString( EGL_NO_DISPLAY, EGL_EXTENSIONS );
+    if ( hasExtension( clientExtensions, "EGL_MESA_platform_surfaceless" ) )
+    {
+        GetPlatformDisplayFunc getPlatformDisplay =
+            (GetPlatformDisplayFunc) eglGetProcAddress( "eglGetPlatformDisplayEXT" );
+        if ( getPlatformDisplay )
+        {
+            EGLDisplay dpy = getPlatformDisplay( EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0 );
+            if ( dpy != EGL_NO_DISPLAY )
+                return dpy;
+        }
+    }
+    return eglGetDisplay( EGL_DEFAULT_DISPLAY );
+}
+
+bool GLQuery::egl( Strings & strings )
+{
+    EGLDisplay dpy = surfacelessDisplay();
+    if ( dpy == EGL_NO_DISPLAY || !eglInitialize( dpy, 0, 0 ) )
+        return false;
+
+    bool ok = false;
+    const char * extensions = eglQueryString( dpy, EGL_EXTENSIONS );
+    GetStringFunc getString = (GetStringFunc) eglGetProcAddress( "glGetString" );
+
+    if ( getString && hasExtension( extensions, "EGL_KHR_surfaceless_context" ) &&
+         eglBindAPI( EGL_OPENGL_API ) )
+    {
+        EGLConfig config = EGL_NO_CONFIG_KHR;
+        if ( !hasExtension( extensions, "EGL_KHR_no_config_context" ) &&
+             !hasExtension( extensions, "EGL_MESA_configless_context" ) )
+        {
+            const EGLint attribs[] = {
+                EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                EGL_NONE
+            };
+            EGLint count = 0;
+            if ( !eglChooseConfig( dpy, attribs, &config, 1, &count ) || count < 1 )
+                config = 0;
+        }
+
+        EGLContext ctx = eglCreateContext( dpy, config, EGL_NO_CONTEXT, 0 );
+        if ( ctx != EGL_NO_CONTEXT )
+        {
+            if ( eglMakeCurrent( dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, ctx ) )
+            {
+                strings.vendor = (const char *) getString( GL_VENDOR );
+                strings.renderer = (const char *) getString( GL_RENDERER );
+                strings.version = (const char *) getString( GL_VERSION );
+                ok = !strings.renderer.isEmpty();
+                eglMakeCurrent( dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT );
+            }
+            eglDestroyContext( dpy, ctx );
+        }
+    }
+
+    eglTerminate( dpy );
+    eglReleaseThread();
+    return ok;
+}
+
+#else
+
+bool GLQuery::egl( Strings & )
+{
+    return false;
+}
+
+#endif
+
+#ifdef HAVE_GLXCHOOSEVISUAL
+
+bool GLQuery::glx( Strings & strings, bool * direct )
+{
+    // our own connection, this may run outside the GUI thread or without
+    // a QApplication at all
+    Display *dpy = XOpenDisplay( 0 );
+    if (!dpy) return false;
+
+    int attribSingle[] = {
+        GLX_RGBA,
+        GLX_RED_SIZE,   1,
+        GLX_GREEN_SIZE, 1,
+        GLX_BLUE_SIZE,  1,
+        None
+    };
+    int attribDouble[] = {
+      GLX_RGBA,
+      GLX_RED_SIZE, 1,
+      GLX_GREEN_SIZE, 1,
+      GLX_BLUE_SIZE, 1,
+      GLX_DOUBLEBUFFER,
+      None
+    };
+
+    int scrnum = DefaultScreen(dpy);
+    XVisualInfo *visinfo = glXChooseVisual(dpy, scrnum, attribSingle);
+    if (!visinfo)
+    {
+        visinfo = glXChooseVisual(dpy, scrnum, attribDouble);
+        if (!visinfo)
+        {
+            fprintf(stderr, "Error: could not find RGB GLX visual\n");
+            XCloseDisplay(dpy);
+            return false;
+        }
+    }
+
+    bool ok = false;
+    GLXContext ctx = glXCreateContext ( dpy, visinfo, NULL, True );
+    if (ctx)
+    {
+        if (direct)
+            *direct = glXIsDirect(dpy, ctx);
+
+        XSetWindowAttributes attr;
+        unsigned long mask;
+        int width = 100, height = 100;
+        Window root = RootWindow(dpy, scrnum);
+
+        attr.background_pixel = 0;
+        attr.border_pixel = 0;
+        attr.colormap = XCreateColormap(dpy, root, visinfo->visual, AllocNone);
+        attr.event_mask = StructureNotifyMask | ExposureMask;
+        mask = CWBackPixel | CWBorderPixel | CWColormap | CWEventMask;
+
+        Window win = XCreateWindow(dpy, root, 0, 0, width, height,
+                                   0, visinfo->depth, InputOutput,
+                                   visinfo->visual, mask, &attr);
+
+        if ( glXMakeCurrent(dpy, win, ctx))
+        {
+            strings.vendor = (const char *) glGetString(GL_VENDOR);
+            strings.renderer = (const char *) glGetString(GL_RENDERER);
+            strings.version = (const char *) glGetString(GL_VERSION);
+            ok = !strings.renderer.isEmpty();
+            glXMakeCurrent(dpy, None, NULL);
+        }
+        XDestroyWindow(dpy, win);
+        XFreeColormap(dpy, attr.colormap);
+
+        glXDestroyContext (dpy,ctx);
+    }
+
+    XFree(visinfo);
+    XCloseDisplay(dpy);
+    return ok;
+}
+
+#else
+
+bool GLQuery::glx( Strings &, bool * )
+{
+    return false;
+}
+
+#endif
+
+bool GLQuery::query( Strings & strings )
+{
+    return egl( strings ) || glx( strings );
+}
+
+static void appendFile( QByteArray & key, const char * path )
+{
+    char buffer[256];
+    const int length = ProcFS::readFile( path, buffer, sizeof( buffer ) );
+    if ( length > 0 )
+        key.append( buffer, length );
+    key.append( ';' );
+}
+
+static void appendLibrary( QByteArray & key, const void * symbol )
+{
+    Dl_info info;
+    struct stat st;
+    if ( symbol && dladdr( symbol, &info ) && info.dli_fname && stat( info.dli_fname, &st ) == 0 )
+    {
+        char buffer[64];
+        snprintf( buffer, sizeof( buffer ), ":%lu:%ld;", (unsigned long) st.st_ino, (long) st.st_mtime );
+        key.append( info.dli_fname );
+        key.append( buffer );
+    }
+}
+
+QByteArray GLQuery::deviceKey()
+{
+    QByteArray key;
+
+    struct utsname uts;
+    if ( uname( &uts ) == 0 )
+    {
+        key.append( uts.release );
+        key.append( ';' );
+    }
+
+    // every DRM node with its PCI ids, kernel driver and driver build
+    DIR * dir = opendir( "/sys/class/drm" );
+    if ( dir )
+    {
+        struct dirent * entry;
+        while ( ( entry = readdir( dir ) ) )
+        {
+            if ( strncmp( entry->d_name, "card", 4 ) != 0 || strchr( entry->d_name, '-' ) )
+                continue;
+
+            char path[PATH_MAX];
+            char link[PATH_MAX];
+            key.append( entry->d_name );
+            key.append( '=' );
+            snprintf( path, sizeof( path ), "/sys/class/drm/%s/device/vendor", entry->d_name );
+            appendFile( key, path );
+            snprintf( path, sizeof( path ), "/sys/class/drm/%s/device/device", entry->d_name );
+            appendFile( key, path );
+
+            snprintf( path, sizeof( path ), "/sys/class/drm/%s/device/driver", entry->d_name );
+            const ssize_t length = readlink( path, link, sizeof( link ) - 1 );
+            if ( length > 0 )
+            {
+                link[length] = '\0';
+                const char * driver = strrchr( link, '/' );
+                driver = driver ? driver + 1 : link;
+                key.append( driver );
+                key.append( ';' );
+                snprintf( path, sizeof( path ), "/sys/module/%s/srcversion", driver );
+                appendFile( key, path );
+                snprintf( path, sizeof( path ), "/sys/module/%s/version", driver );
+                appendFile( key, path );
+            }
+        }
+        closedir( dir );
+    }
+
+    // the userspace side, a Mesa or binary driver upgrade replaces these
+#ifdef HAVE_EGL
+    appendLibrary( key, (const void *) &eglGetDisplay );
+#endif
+#ifdef HAVE_GLXCHOOSEVISUAL
+    appendLibrary( key, (const void *) &glXChooseVisual );
+#endif
+
+    return key;
+}
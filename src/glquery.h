@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////
+// glquery.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _glquery_H_
+#define _glquery_H_
+
+#include <qbytearray.h>
+
+/**
+ * In-process OpenGL vendor/renderer/version queries, replacing glxinfo
+ */
+namespace GLQuery
+{
+    struct Strings
+    {
+        QByteArray vendor;
+        QByteArray renderer;
+        QByteArray version;
+    };
+
+    /**
+     * Query the strings from a surfaceless EGL context, which needs neither
+     * an X server nor a window and works with Mesa's llvmpipe
+     * @return false if EGL support isn't built in or no context could be made
+     */
+    bool egl( Strings & strings );
+
+    /**
+     * Query the strings from a GLX context on a private connection to
+     * $DISPLAY. @p direct tells whether the context does direct rendering.
+     * @return false if GLX support isn't built in or no context could be made
+     */
+    bool glx( Strings & strings, bool * direct = 0 );
+
+    /**
+     * Try egl() first, then glx()
+     */
+    bool query( Strings & strings );
+
+    /**
+     * @return a key identifying the DRM devices and their kernel drivers,
+     * used to tell whether cached strings are still valid
+     */
+    QByteArray deviceKey();
+}
+
+#endif
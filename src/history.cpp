@@ -0,0 +1,196 @@
+//////////////////////////////////////////////////////////////////////////
+// history.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "history.h"
+#include "diskspace.h"
+#include "meminfo.h"
+#include "procfs.h"
+
+#include <QVector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// disk sizes are kept in MiB, memory in 64 KiB units
+#define DISK_UNIT ( Q_INT64_C( 1 ) << 20 )
+#define MEMORY_UNIT ( Q_INT64_C( 1 ) << 16 )
+
+static qint64 monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return qint64( ts.tv_sec ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+/*
+ * Mean "capacity" of the power supplies whose "type" is "Battery"
+ * @return -1 if there is none
+ */
+static int batteryCharge()
+{
+    DIR * dir = opendir( "/sys/class/power_supply" );
+    if ( !dir )
+        return -1;
+
+    const int rootFd = dirfd( dir );
+    char path[300];
+    char buffer[32];
+    int sum = 0, count = 0;
+    while ( struct dirent * entry = readdir( dir ) )
+    {
+        if ( entry->d_name[0] == '.' )
+            continue;
+        snprintf( path, sizeof( path ), "%s/type", entry->d_name );
+        if ( ProcFS::readFileAt( rootFd, path, buffer, sizeof( buffer ) ) <= 0 || strncmp( buffer, "Battery", 7 ) != 0 )
+            continue;
+        snprintf( path, sizeof( path ), "%s/capacity", entry->d_name );
+        const int length = ProcFS::readFileAt( rootFd, path, buffer, sizeof( buffer ) );
+        if ( length <= 0 )
+            continue;
+        sum += ProcFS::toULong( buffer, buffer + length );
+        ++count;
+    }
+    closedir( dir );
+    return count ? sum / count : -1;
+}
+
+History::History( int minutes, int resolution, int statfsTimeout, int retryInterval )
+    : m_capacity( qMax( minutes * 60 / qMax( resolution, 1 ), 2 ) ),
+      m_resolution( qMax( resolution, 1 ) * 1000 ),
+      m_statfsTimeout( statfsTimeout ),
+      m_retryInterval( retryInterval ),
+      m_stop( false )
+{
+    m_series[MemoryUsed] = new TimeSeries( m_capacity, m_resolution, MEMORY_UNIT );
+    m_series[SwapUsed] = new TimeSeries( m_capacity, m_resolution, MEMORY_UNIT );
+    m_series[BatteryCharge] = new TimeSeries( m_capacity, m_resolution );
+}
+
+History::~History()
+{
+    stop();
+    wait();
+
+    for ( int i = 0; i < METRIC_COUNT; ++i )
+        delete m_series[i];
+    qDeleteAll( m_disks );
+}
+
+void History::stop()
+{
+    QMutexLocker locker( &m_lock );
+    m_stop = true;
+    m_wake.wakeAll();
+}
+
+bool History::isStopping() const
+{
+    QMutexLocker locker( &m_lock );
+    return m_stop;
+}
+
+void History::setMountPoints( const QStringList & mountPoints )
+{
+    QMutexLocker locker( &m_lock );
+    m_mountPoints = mountPoints;
+}
+
+const TimeSeries * History::disk( const QString & mountPoint ) const
+{
+    // only the lookup is locked, the series itself never goes away
+    QMutexLocker locker( &m_lock );
+    return m_disks.value( mountPoint );
+}
+
+QStringList History::disks() const
+{
+    QMutexLocker locker( &m_lock );
+    return m_disks.keys();
+}
+
+void History::run()
+{
+    QMutexLocker locker( &m_lock );
+    while ( !m_stop )
+    {
+        locker.unlock();
+        sample();
+        locker.relock();
+
+        // wake up at the next multiple of the resolution, so points don't drift
+        const qint64 now = monotonicMs();
+        if ( !m_stop )
+            m_wake.wait( &m_lock, m_resolution - now % m_resolution );
+    }
+}
+
+void History::sample()
+{
+    const qint64 now = monotonicMs();
+
+    MemInfo mem;
+    if ( mem.read() )
+    {
+        const quint64 available = mem.has( &MemInfo::memAvailable ) ? mem.memAvailable :
+                                  mem.memFree + mem.cached + mem.buffers;
+        m_series[MemoryUsed]->append( now, qint64( mem.memTotal - qMin( available, mem.memTotal ) ) * 1024 );
+        m_series[SwapUsed]->append( now, qint64( mem.swapTotal - qMin( mem.swapFree, mem.swapTotal ) ) * 1024 );
+    }
+
+    const int charge = batteryCharge();
+    if ( charge >= 0 )
+        m_series[BatteryCharge]->append( now, charge );
+
+    m_lock.lock();
+    QVector<DiskSpace::Request> requests( m_mountPoints.size() );
+    for ( int i = 0; i < m_mountPoints.size(); ++i )
+    {
+        requests[i].mountPoint = m_mountPoints.at( i );
+        requests[i].total = requests[i].avail = 0;
+        requests[i].state = DiskSpace::Failed;
+    }
+    m_lock.unlock();
+    if ( requests.isEmpty() )
+        return;
+
+    DiskSpace::query( requests, m_statfsTimeout, m_retryInterval );
+
+    for ( int i = 0; i < requests.size(); ++i )
+    {
+        const DiskSpace::Request & request = requests.at( i );
+        if ( request.state != DiskSpace::Ok )
+            continue;
+
+        m_lock.lock();
+        TimeSeries * series = m_disks.value( request.mountPoint );
+        if ( !series )
+        {
+            series = new TimeSeries( m_capacity, m_resolution, DISK_UNIT );
+            m_disks.insert( request.mountPoint, series );
+        }
+        m_lock.unlock();
+        series->append( now, request.total - request.avail );
+    }
+}
@@ -0,0 +1,115 @@
+//////////////////////////////////////////////////////////////////////////
+// history.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _history_H_
+#define _history_H_
+
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "timeseries.h"
+
+/**
+ * Recent history of memory, swap, battery and disk usage.
+ *
+ * A thread of the sampler daemon samples every metric once per resolution
+ * into a TimeSeries and the daemon publishes the points with SamplerData.
+ * Without a sampler the slave runs its own, and the page reads the series
+ * without locking to draw sparklines. Battery charge is read from
+ * /sys/class/power_supply, as Solid can only be used from the main thread.
+ */
+class History : public QThread
+{
+public:
+    enum Metric
+    {
+        MemoryUsed = 0,     // MemTotal - MemAvailable, in bytes
+        SwapUsed,           // in bytes
+        BatteryCharge,      // percent, averaged over all batteries
+        METRIC_COUNT
+    };
+
+    /**
+     * @param minutes how far back the history goes
+     * @param resolution seconds per point
+     * @param statfsTimeout, retryInterval passed on to DiskSpace::query()
+     */
+    History( int minutes, int resolution, int statfsTimeout, int retryInterval );
+
+    /**
+     * Stops the sampling thread
+     */
+    ~History();
+
+    /**
+     * Ask the sampling thread to stop, without waiting for it to finish
+     * the sample it is taking. The series are kept until the destructor.
+     */
+    void stop();
+
+    /**
+     * @return true once stop() was called
+     */
+    bool isStopping() const;
+
+    /**
+     * Set the mount points whose usage is sampled, the history of the
+     * others is kept in case they come back
+     */
+    void setMountPoints( const QStringList & mountPoints );
+
+    const TimeSeries & series( Metric metric ) const { return *m_series[metric]; }
+
+    /**
+     * @return the used space of @p mountPoint, 0 if it isn't sampled
+     */
+    const TimeSeries * disk( const QString & mountPoint ) const;
+
+    /**
+     * @return the mount points disk() has a series for
+     */
+    QStringList disks() const;
+
+    int minutes() const { return m_capacity * m_resolution / 60000; }
+
+protected:
+    void run();
+
+private:
+    void sample();
+
+    const int m_capacity;
+    const int m_resolution;     // in ms
+    const int m_statfsTimeout;
+    const int m_retryInterval;
+    TimeSeries * m_series[METRIC_COUNT];
+
+    mutable QMutex m_lock;      // guards everything below
+    QWaitCondition m_wake;
+    bool m_stop;
+    QStringList m_mountPoints;
+    QHash<QString, TimeSeries *> m_disks;
+};
+
+#endif
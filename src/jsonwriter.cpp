@@ -0,0 +1,237 @@
+//////////////////////////////////////////////////////////////////////////
+// jsonwriter.cpp                                                       //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "jsonwriter.h"
+
+#include <QString>
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+JsonWriter::JsonWriter()
+    : m_afterKey( false )
+{
+}
+
+void JsonWriter::separate()
+{
+    if ( m_afterKey )
+    {
+        m_afterKey = false;
+        return;
+    }
+    if ( !m_first.isEmpty() )
+    {
+        if ( m_first.last() )
+            m_first.last() = false;
+        else
+            m_buffer += ',';
+    }
+}
+
+void JsonWriter::beginObject()
+{
+    separate();
+    m_buffer += '{';
+    m_first.append( true );
+}
+
+void JsonWriter::endObject()
+{
+    m_buffer += '}';
+    m_first.remove( m_first.size() - 1 );
+}
+
+void JsonWriter::beginArray()
+{
+    separate();
+    m_buffer += '[';
+    m_first.append( true );
+}
+
+void JsonWriter::endArray()
+{
+    m_buffer += ']';
+    m_first.remove( m_first.size() - 1 );
+}
+
+void JsonWriter::key( const char * name )
+{
+    separate();
+    appendString( name, strlen( name ) );
+    m_buffer += ':';
+    m_afterKey = true;
+}
+
+/*
+ * @return the length of the well-formed UTF-8 sequence which starts at
+ * @p p with a byte >= 0x80, 0 if it's malformed or cut off by @p end
+ */
+static int sequenceLength( const unsigned char * p, const unsigned char * end )
+{
+    // the second byte has a narrower range for some lead bytes, which
+    // rules out overlong forms, surrogates and anything above U+10FFFF
+    int length;
+    unsigned char low = 0x80, high = 0xbf;
+    if ( *p >= 0xc2 && *p <= 0xdf )
+        length = 2;
+    else if ( *p >= 0xe0 && *p <= 0xef )
+    {
+        length = 3;
+        if ( *p == 0xe0 )
+            low = 0xa0;
+        else if ( *p == 0xed )
+            high = 0x9f;
+    }
+    else if ( *p >= 0xf0 && *p <= 0xf4 )
+    {
+        length = 4;
+        if ( *p == 0xf0 )
+            low = 0x90;
+        else if ( *p == 0xf4 )
+            high = 0x8f;
+    }
+    else
+        return 0;
+
+    if ( end - p < length || p[1] < low || p[1] > high )
+        return 0;
+    for ( int i = 2; i < length; ++i )
+        if ( ( p[i] & 0xc0 ) != 0x80 )
+            return 0;
+    return length;
+}
+
+void JsonWriter::appendString( const char * string, int length )
+{
+    static const char hex[] = "0123456789abcdef";
+
+    m_buffer += '"';
+    const char * run = string;
+    const char * const end = string + length;
+    for ( const char * p = string; p < end; ++p )
+    {
+        const unsigned char c = *p;
+        if ( c >= 0x20 && c < 0x80 && c != '"' && c != '\\' )
+            continue;
+
+        if ( c >= 0x80 )
+        {
+            const int sequence = sequenceLength( reinterpret_cast<const unsigned char *>( p ),
+                                                 reinterpret_cast<const unsigned char *>( end ) );
+            if ( sequence )
+            {
+                p += sequence - 1;
+                continue;
+            }
+            // labels and command output can be in any encoding
+            m_buffer.append( run, p - run );
+            run = p + 1;
+            m_buffer += "\\ufffd";
+            continue;
+        }
+
+        m_buffer.append( run, p - run );
+        run = p + 1;
+        switch ( c )
+        {
+        case '"':  m_buffer += "\\\""; break;
+        case '\\': m_buffer += "\\\\"; break;
+        case '\n': m_buffer += "\\n"; break;
+        case '\r': m_buffer += "\\r"; break;
+        case '\t': m_buffer += "\\t"; break;
+        default:
+            m_buffer += "\\u00";
+            m_buffer += hex[c >> 4];
+            m_buffer += hex[c & 0xf];
+        }
+    }
+    m_buffer.append( run, end - run );
+    m_buffer += '"';
+}
+
+void JsonWriter::value( const QString & string )
+{
+    if ( string.isNull() )
+    {
+        null();
+        return;
+    }
+    value( string.toUtf8() );
+}
+
+void JsonWriter::value( const QByteArray & string )
+{
+    separate();
+    appendString( string.constData(), string.size() );
+}
+
+void JsonWriter::value( const char * string )
+{
+    separate();
+    appendString( string, strlen( string ) );
+}
+
+void JsonWriter::value( qint64 number )
+{
+    char buffer[32];
+    separate();
+    m_buffer.append( buffer, snprintf( buffer, sizeof( buffer ), "%lld", (long long) number ) );
+}
+
+void JsonWriter::value( quint64 number )
+{
+    char buffer[32];
+    separate();
+    m_buffer.append( buffer, snprintf( buffer, sizeof( buffer ), "%llu", (unsigned long long) number ) );
+}
+
+void JsonWriter::value( double number )
+{
+    if ( isnan( number ) || isinf( number ) )
+    {
+        null();
+        return;
+    }
+    separate();
+    m_buffer += QByteArray::number( number, 'g', 15 );   // unlike printf, not localized
+}
+
+void JsonWriter::value( bool flag )
+{
+    separate();
+    m_buffer += flag ? "true" : "false";
+}
+
+void JsonWriter::null()
+{
+    separate();
+    m_buffer += "null";
+}
+
+QByteArray JsonWriter::take()
+{
+    QByteArray chunk;
+    chunk.swap( m_buffer );
+    m_buffer.reserve( chunk.capacity() );
+    return chunk;
+}
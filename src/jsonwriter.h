@@ -0,0 +1,88 @@
+//////////////////////////////////////////////////////////////////////////
+// jsonwriter.h                                                         //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _jsonwriter_H_
+#define _jsonwriter_H_
+
+#include <qbytearray.h>
+#include <qvector.h>
+
+class QString;
+
+/**
+ * Streaming JSON writer
+ *
+ * Appends UTF-8 encoded JSON to an internal buffer as the calls come in,
+ * there is no document tree. The caller takes the buffer whenever it grows
+ * past a convenient chunk size and sends it on, see take().
+ *
+ * Commas and colons are inserted automatically, inside an object every
+ * value has to be preceded by key(). Strings are taken as UTF-8, every byte
+ * which isn't part of a well-formed sequence is written as U+FFFD.
+ */
+class JsonWriter
+{
+public:
+    JsonWriter();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+
+    void key( const char * name );
+
+    void value( const QString & string );
+    void value( const QByteArray & string );    // UTF-8
+    void value( const char * string );          // UTF-8
+    void value( qint64 number );
+    void value( quint64 number );
+    void value( int number ) { value( qint64( number ) ); }
+    void value( double number );                // NaN and infinity become null
+    void value( bool flag );
+    void null();
+
+    /**
+     * Shorthand for key() followed by value()
+     */
+    template <typename T>
+    void field( const char * name, const T & v ) { key( name ); value( v ); }
+
+    /**
+     * @return the number of bytes written but not taken yet
+     */
+    int pending() const { return m_buffer.size(); }
+
+    /**
+     * @return the bytes written since the last call, emptying the buffer
+     */
+    QByteArray take();
+
+private:
+    void separate();
+    void appendString( const char * string, int length );
+
+    QByteArray m_buffer;
+    QVector<bool> m_first;      // per open object/array: no value written yet
+    bool m_afterKey;
+};
+
+#endif
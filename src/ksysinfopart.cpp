@@ -20,6 +20,8 @@
 #include "ksysinfopart.h"
 
 #include <qtimer.h>
+#include <qsocketnotifier.h>
+#include <qprocess.h>
 #include <QMouseEvent>
 #include <kcomponentdata.h>
 #include <kglobal.h>
@@ -31,10 +33,15 @@
 #include <kmenu.h>
 #include <khtmlview.h>
 #include <khtml_events.h>
+#include <dom/html_document.h>
+#include <dom/html_element.h>
 #include <qcursor.h>
 #include <kio/netaccess.h>
+#include <kio/job.h>
 #include <kfileitem.h>
 #include <KDesktopFile>
+#include <KConfigGroup>
+#include <KSharedConfig>
 
 //solid
 #include <solid/networking.h>
@@ -48,6 +55,11 @@
 #include <solid/opticaldisc.h>
 #include <solid/opticaldrive.h>
 
+// quiet time after a change notification before the page is reloaded, and
+// the longest a reload is put off by a steady stream of notifications
+#define REFRESH_DELAY_MS 300
+#define REFRESH_MAX_DELAY_MS 2000
+
 extern "C"
 {
     KDE_EXPORT void* init_libksysinfopart()
@@ -99,24 +111,55 @@ KSysinfoPart::KSysinfoPart( QWidget * parent )
     rescanTimer->setSingleShot(true);
     // Disable reloading as requested
     // rescanTimer->start(20000);
+    m_pendingChanges = 0;
+    m_loading = false;
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setSingleShot(true);
+    connect(m_refreshTimer, SIGNAL(timeout()), SLOT(refresh()));
+    connect(this, SIGNAL(started(KIO::Job *)), SLOT(onLoadStarted()));
+    connect(this, SIGNAL(completed()), SLOT(onLoadFinished()));
+    connect(this, SIGNAL(canceled(const QString &)), SLOT(onLoadFinished()));
     setJScriptEnabled(false);
     setJavaEnabled(false);
     setPluginsEnabled(false);
     setMetaRefreshEnabled(false);
 
     connect(Solid::Networking::notifier(), SIGNAL(statusChanged(Solid::Networking::Status)),
-            this, SLOT(rescan()));
+            this, SLOT(onNetworkChanged()));
     connect(Solid::DeviceNotifier::instance(), SIGNAL(deviceAdded(const QString &)),
             this, SLOT(onDeviceAdded(const QString &)));
     connect(Solid::DeviceNotifier::instance(), SIGNAL(deviceRemoved(const QString &)),
-            this, SLOT(rescan()));
+            this, SLOT(onDisksChanged()));
 
     QList<Solid::Device> deviceList = Solid::Device::listFromQuery("IS StorageAccess");
     Q_FOREACH (const Solid::Device &device, deviceList)
     {
         const Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
         connect(access, SIGNAL(accessibilityChanged(bool, const QString &)),
-                this, SLOT(rescan()));
+                this, SLOT(onDisksChanged()));
+    }
+
+    // the sampler keeps the slave's collectors warm; it exits by itself once
+    // no page has been loaded for a while, and a second one doesn't start
+    const KSharedConfigPtr config = KSharedConfig::openConfig( "kio_sysinforc" );
+    if ( KConfigGroup( config, "Sampler" ).readEntry( "Autostart", false ) )
+        QProcess::startDetached( "kio_sysinfo_sampler", QStringList() << "--idle-exit" );
+
+    // same settings as the slave, see sysinfo.cpp
+    const KConfigGroup cg( config, "Pressure" );
+    if ( cg.readEntry( "Triggers", false ) &&
+         m_pressure.arm( cg.readEntry( "TriggerStall", PRESSURE_STALL_MS ),
+                         cg.readEntry( "TriggerWindow", PRESSURE_WINDOW_MS ) ) )
+    {
+        for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+        {
+            const int fd = m_pressure.fd( Pressure::Resource( i ) );
+            if ( fd < 0 )
+                continue;
+            // POLLPRI shows up as an exception to select()
+            QSocketNotifier *notifier = new QSocketNotifier( fd, QSocketNotifier::Exception, this );
+            connect( notifier, SIGNAL(activated(int)), SLOT(onPressure()) );
+        }
     }
 
     installEventFilter( this );
@@ -239,18 +282,143 @@ void KSysinfoPart::onDeviceAdded(const QString &udi) {
     Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
     if (access) {
         connect(access, SIGNAL(accessibilityChanged(bool, const QString &)),
-                this, SLOT(rescan()));
+                this, SLOT(onDisksChanged()));
     }
-    rescan();
+    scheduleRefresh(DisksChanged);
+}
+
+void KSysinfoPart::onDisksChanged()
+{
+    scheduleRefresh(DisksChanged);
+}
+
+void KSysinfoPart::onNetworkChanged()
+{
+    scheduleRefresh(NetworkChanged);
+}
+
+void KSysinfoPart::onPressure()
+{
+    // a trigger fires once per window for as long as the stall lasts, don't
+    // add to the load by reloading the page that often
+    if ( !m_lastPressureRescan.isNull() && m_lastPressureRescan.elapsed() < 10000 )
+        return;
+    m_lastPressureRescan.start();
+    scheduleRefresh(PressureChanged);
 }
 
 void KSysinfoPart::rescan()
 {
+    scheduleRefresh(EverythingChanged);
+}
+
+void KSysinfoPart::scheduleRefresh( int changes )
+{
+    if ( !m_pendingChanges )
+        m_firstPendingChange.start();
+    m_pendingChanges |= changes;
+
+    // restart the quiet period, but don't let a steady trickle of events
+    // put the reload off forever
+    const int waited = m_firstPendingChange.elapsed();
+    m_refreshTimer->start( qMax( 0, qMin( REFRESH_DELAY_MS, REFRESH_MAX_DELAY_MS - waited ) ) );
+}
+
+void KSysinfoPart::refresh()
+{
+    const int changes = m_pendingChanges;
+    m_pendingChanges = 0;
+    if ( !changes )
+        return;
+
+    // only the sections which changed, if the page is there to patch
+    if ( !( changes & ~( DisksChanged | NetworkChanged | PressureChanged ) ) && canPatchSections() )
+    {
+        kDebug(1242) << "Refreshing sections, changes:" << changes;
+        if ( changes & DisksChanged )
+            refreshSection( "disks" );
+        if ( changes & NetworkChanged )
+            refreshSection( "net" );
+        if ( changes & PressureChanged )
+        {
+            refreshSection( "pressure" );
+            refreshSection( "memory" );
+        }
+        return;
+    }
+
+    // whatever is still loading predates the changes, drop it instead of
+    // letting the slave finish a page nobody will look at
+    if ( m_loading )
+    {
+        kDebug(1242) << "Dropping stale reload";
+        closeUrl();
+    }
+    Q_FOREACH ( KIO::StoredTransferJob *job, m_sectionJobs )
+        job->kill();
+    m_sectionJobs.clear();
+
+    kDebug(1242) << "Reloading, changes:" << changes;
     openUrl(KUrl("sysinfo:/"));
     rescanTimer->stop();
     rescanTimer->start(20000);
 }
 
+bool KSysinfoPart::canPatchSections() const
+{
+    return !m_loading && url().protocol() == "sysinfo" &&
+           ( url().path().isEmpty() || url().path() == "/" ) && !url().hasQueryItem( "format" );
+}
+
+void KSysinfoPart::refreshSection( const QString &name )
+{
+    // a fetch still running for the section is stale now
+    if ( KIO::StoredTransferJob *job = m_sectionJobs.take( name ) )
+        job->kill();
+
+    KIO::StoredTransferJob *job = KIO::storedGet( KUrl( "sysinfo:/section/" + name ), KIO::Reload, KIO::HideProgressInfo );
+    job->setProperty( "section", name );
+    connect( job, SIGNAL(result(KJob *)), SLOT(onSectionResult(KJob *)) );
+    m_sectionJobs.insert( name, job );
+}
+
+void KSysinfoPart::onSectionResult( KJob *job )
+{
+    KIO::StoredTransferJob *sjob = static_cast<KIO::StoredTransferJob *>( job );
+    const QString name = job->property( "section" ).toString();
+    if ( m_sectionJobs.value( name ) != sjob )
+        return;
+    m_sectionJobs.remove( name );
+
+    if ( job->error() )
+    {
+        kDebug(1242) << "Can't refresh section" << name << ":" << job->errorString();
+        return;
+    }
+    // the page may have been reloaded or left meanwhile
+    if ( !canPatchSections() )
+        return;
+
+    DOM::HTMLElement element;
+    element = htmlDocument().getElementById( "section-" + name );
+    if ( element.isNull() )
+    {
+        rescan();
+        return;
+    }
+    element.setInnerHTML( QString::fromUtf8( sjob->data() ) );
+}
+
+void KSysinfoPart::onLoadStarted()
+{
+    m_loading = true;
+}
+
+void KSysinfoPart::onLoadFinished()
+{
+    m_loading = false;
+}
+
 #ifdef PORTED
 void KSysinfoPart::FilesAdded( const KUrl & dir )
 {
@@ -32,6 +32,11 @@
 //solid
 #include <solid/device.h>
 
+#include <qdatetime.h>
+#include <qmap.h>
+
+#include "pressure.h"
+
 class KComponentData;
 class KAboutData;
 
@@ -64,15 +69,67 @@ class KSysinfoPart : public KHTMLPart
    public:
       KSysinfoPart( QWidget * parent );
 
+      /**
+       * What changed, as recorded by scheduleRefresh()
+       */
+      enum Change
+      {
+         DisksChanged = 1,
+         NetworkChanged = 2,
+         PressureChanged = 4,
+         EverythingChanged = 0xff
+      };
+
    protected slots:
       void onDeviceAdded(const QString &udi);
+      void onDisksChanged();
+      void onNetworkChanged();
       void rescan();
+      void onPressure();
+      void refresh();
+      void onLoadStarted();
+      void onLoadFinished();
+      void onSectionResult( KJob *job );
       void slotResult( KJob *job );
 
    protected:
+      /**
+       * Note that @p changes happened and reload once events stop coming in.
+       *
+       * Solid reports a hub with several partitions as a burst of
+       * deviceAdded() and accessibilityChanged() signals; they are coalesced
+       * into a single reload, at most REFRESH_MAX_DELAY_MS after the first.
+       */
+      void scheduleRefresh( int changes );
+
+      /**
+       * Fetch sysinfo:/section/@p name and put it in place of the section's
+       * contents in the current page
+       */
+      void refreshSection( const QString &name );
+
+      /**
+       * @return whether the sysinfo:/ overview is shown and fully loaded,
+       * i.e. sections can be patched
+       */
+      bool canPatchSections() const;
+
       KComponentData *m_instance;
       QTimer *rescanTimer;
 
+      // coalesces change notifications, see scheduleRefresh()
+      QTimer *m_refreshTimer;
+      QTime m_firstPendingChange;
+      int m_pendingChanges;
+      bool m_loading;
+
+      // running section fetches, by section name
+      QMap<QString, KIO::StoredTransferJob *> m_sectionJobs;
+
+      // live mode: PSI triggers reload the page as soon as something stalls
+      PressureMonitor m_pressure;
+      QTime m_lastPressureRescan;
+
 #ifdef PORTED
       // Reimplemented from KDirNotify
       virtual void FilesAdded( const KUrl & dir );
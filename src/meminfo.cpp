@@ -0,0 +1,169 @@
+//////////////////////////////////////////////////////////////////////////
+// meminfo.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "meminfo.h"
+#include "procfs.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// in /proc/meminfo order, so the scan mostly hits the first candidate
+static const ProcFS::Field<MemInfo> memInfoFields[] = {
+    { "MemTotal",          &MemInfo::memTotal },
+    { "MemFree",           &MemInfo::memFree },
+    { "MemAvailable",      &MemInfo::memAvailable },
+    { "Buffers",           &MemInfo::buffers },
+    { "Cached",            &MemInfo::cached },
+    { "SwapCached",        &MemInfo::swapCached },
+    { "Active",            &MemInfo::active },
+    { "Inactive",          &MemInfo::inactive },
+    { "Active(anon)",      &MemInfo::activeAnon },
+    { "Inactive(anon)",    &MemInfo::inactiveAnon },
+    { "Active(file)",      &MemInfo::activeFile },
+    { "Inactive(file)",    &MemInfo::inactiveFile },
+    { "Unevictable",       &MemInfo::unevictable },
+    { "Mlocked",           &MemInfo::mlocked },
+    { "SwapTotal",         &MemInfo::swapTotal },
+    { "SwapFree",          &MemInfo::swapFree },
+    { "Zswap",             &MemInfo::zswap },
+    { "Zswapped",          &MemInfo::zswapped },
+    { "Dirty",             &MemInfo::dirty },
+    { "Writeback",         &MemInfo::writeback },
+    { "AnonPages",         &MemInfo::anonPages },
+    { "Mapped",            &MemInfo::mapped },
+    { "Shmem",             &MemInfo::shmem },
+    { "KReclaimable",      &MemInfo::kReclaimable },
+    { "Slab",              &MemInfo::slab },
+    { "SReclaimable",      &MemInfo::sReclaimable },
+    { "SUnreclaim",        &MemInfo::sUnreclaim },
+    { "KernelStack",       &MemInfo::kernelStack },
+    { "PageTables",        &MemInfo::pageTables },
+    { "SecPageTables",     &MemInfo::secPageTables },
+    { "NFS_Unstable",      &MemInfo::nfsUnstable },
+    { "Bounce",            &MemInfo::bounce },
+    { "WritebackTmp",      &MemInfo::writebackTmp },
+    { "CommitLimit",       &MemInfo::commitLimit },
+    { "Committed_AS",      &MemInfo::committedAS },
+    { "VmallocTotal",      &MemInfo::vmallocTotal },
+    { "VmallocUsed",       &MemInfo::vmallocUsed },
+    { "VmallocChunk",      &MemInfo::vmallocChunk },
+    { "Percpu",            &MemInfo::percpu },
+    { "HardwareCorrupted", &MemInfo::hardwareCorrupted },
+    { "AnonHugePages",     &MemInfo::anonHugePages },
+    { "ShmemHugePages",    &MemInfo::shmemHugePages },
+    { "ShmemPmdMapped",    &MemInfo::shmemPmdMapped },
+    { "FileHugePages",     &MemInfo::fileHugePages },
+    { "FilePmdMapped",     &MemInfo::filePmdMapped },
+    { "CmaTotal",          &MemInfo::cmaTotal },
+    { "CmaFree",           &MemInfo::cmaFree },
+    { "HugePages_Total",   &MemInfo::hugePagesTotal },
+    { "HugePages_Free",    &MemInfo::hugePagesFree },
+    { "HugePages_Rsvd",    &MemInfo::hugePagesRsvd },
+    { "HugePages_Surp",    &MemInfo::hugePagesSurp },
+    { "Hugepagesize",      &MemInfo::hugepagesize },
+    { "Hugetlb",           &MemInfo::hugetlb },
+    { "DirectMap4k",       &MemInfo::directMap4k },
+    { "DirectMap2M",       &MemInfo::directMap2M },
+    { "DirectMap1G",       &MemInfo::directMap1G }
+};
+
+static const int memInfoFieldCount = sizeof( memInfoFields ) / sizeof( *memInfoFields );
+
+bool MemInfo::read( const char * path )
+{
+    char buffer[8192];
+    const int length = ProcFS::readFile( path, buffer, sizeof( buffer ) );
+    if ( length < 0 )
+    {
+        memset( this, 0, sizeof( *this ) );
+        return false;
+    }
+    return parse( buffer, length );
+}
+
+bool MemInfo::parse( const char * data, int length )
+{
+    memset( this, 0, sizeof( *this ) );
+    present = ProcFS::scanFields( data, length, memInfoFields, memInfoFieldCount, *this );
+    return present != 0;
+}
+
+bool MemInfo::has( quint64 MemInfo::*field ) const
+{
+    for ( int i = 0; i < memInfoFieldCount; ++i )
+        if ( memInfoFields[i].member == field )
+            return present & ( Q_UINT64_C( 1 ) << i );
+    return false;
+}
+
+int MemInfo::fieldCount()
+{
+    return memInfoFieldCount;
+}
+
+const char * MemInfo::fieldName( int field )
+{
+    return memInfoFields[field].key;
+}
+
+quint64 MemInfo::value( int field ) const
+{
+    return this->*( memInfoFields[field].member );
+}
+
+/*
+ * "orig_data_size compr_data_size mem_used_total mem_limit mem_used_max
+ * same_pages pages_compacted huge_pages huge_pages_since"
+ */
+bool ZramInfo::read( const char * root )
+{
+    memset( this, 0, sizeof( *this ) );
+
+    DIR * dir = opendir( root );
+    if ( !dir )
+        return false;
+
+    const int rootFd = dirfd( dir );
+    char path[300];
+    char buffer[256];
+    while ( struct dirent * entry = readdir( dir ) )
+    {
+        if ( strncmp( entry->d_name, "zram", 4 ) != 0 )
+            continue;
+        snprintf( path, sizeof( path ), "%s/mm_stat", entry->d_name );
+        const int length = ProcFS::readFileAt( rootFd, path, buffer, sizeof( buffer ) );
+        if ( length <= 0 )
+            continue;
+
+        quint64 * const fields[3] = { &origDataSize, &comprDataSize, &memUsedTotal };
+        const char * p = buffer;
+        const char * word;
+        int wordLength;
+        for ( int i = 0; i < 3 && ProcFS::nextWord( p, buffer + length, word, wordLength ); ++i )
+            *fields[i] += ProcFS::toULong( word, word + wordLength );
+        ++devices;
+    }
+    closedir( dir );
+    return devices > 0;
+}
@@ -0,0 +1,138 @@
+//////////////////////////////////////////////////////////////////////////
+// meminfo.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _meminfo_H_
+#define _meminfo_H_
+
+#include <qglobal.h>
+
+/**
+ * Typed contents of /proc/meminfo
+ *
+ * All sizes are in KiB as reported by the kernel, except the HugePages_*
+ * counters which are page counts. Fields the running kernel doesn't know
+ * about are 0, use has() to tell them apart from a real 0.
+ */
+struct MemInfo
+{
+    quint64 memTotal;          // MemTotal
+    quint64 memFree;           // MemFree
+    quint64 memAvailable;      // MemAvailable
+    quint64 buffers;           // Buffers
+    quint64 cached;            // Cached
+    quint64 swapCached;        // SwapCached
+    quint64 active;            // Active
+    quint64 inactive;          // Inactive
+    quint64 activeAnon;        // Active(anon)
+    quint64 inactiveAnon;      // Inactive(anon)
+    quint64 activeFile;        // Active(file)
+    quint64 inactiveFile;      // Inactive(file)
+    quint64 unevictable;       // Unevictable
+    quint64 mlocked;           // Mlocked
+    quint64 swapTotal;         // SwapTotal
+    quint64 swapFree;          // SwapFree
+    quint64 zswap;             // Zswap
+    quint64 zswapped;          // Zswapped
+    quint64 dirty;             // Dirty
+    quint64 writeback;         // Writeback
+    quint64 anonPages;         // AnonPages
+    quint64 mapped;            // Mapped
+    quint64 shmem;             // Shmem
+    quint64 kReclaimable;      // KReclaimable
+    quint64 slab;              // Slab
+    quint64 sReclaimable;      // SReclaimable
+    quint64 sUnreclaim;        // SUnreclaim
+    quint64 kernelStack;       // KernelStack
+    quint64 pageTables;        // PageTables
+    quint64 secPageTables;     // SecPageTables
+    quint64 nfsUnstable;       // NFS_Unstable
+    quint64 bounce;            // Bounce
+    quint64 writebackTmp;      // WritebackTmp
+    quint64 commitLimit;       // CommitLimit
+    quint64 committedAS;       // Committed_AS
+    quint64 vmallocTotal;      // VmallocTotal
+    quint64 vmallocUsed;       // VmallocUsed
+    quint64 vmallocChunk;      // VmallocChunk
+    quint64 percpu;            // Percpu
+    quint64 hardwareCorrupted; // HardwareCorrupted
+    quint64 anonHugePages;     // AnonHugePages
+    quint64 shmemHugePages;    // ShmemHugePages
+    quint64 shmemPmdMapped;    // ShmemPmdMapped
+    quint64 fileHugePages;     // FileHugePages
+    quint64 filePmdMapped;     // FilePmdMapped
+    quint64 cmaTotal;          // CmaTotal
+    quint64 cmaFree;           // CmaFree
+    quint64 hugePagesTotal;    // HugePages_Total
+    quint64 hugePagesFree;     // HugePages_Free
+    quint64 hugePagesRsvd;     // HugePages_Rsvd
+    quint64 hugePagesSurp;     // HugePages_Surp
+    quint64 hugepagesize;      // Hugepagesize
+    quint64 hugetlb;           // Hugetlb
+    quint64 directMap4k;       // DirectMap4k
+    quint64 directMap2M;       // DirectMap2M
+    quint64 directMap1G;       // DirectMap1G
+
+    quint64 present;    // bitmask of the fields found, see has()
+
+    /**
+     * Read @p path with a single read(2) into a stack buffer and parse it,
+     * doesn't allocate
+     */
+    bool read( const char * path = "/proc/meminfo" );
+
+    /**
+     * Parse meminfo formatted @p data in a single pass
+     * @return false if no known field was found
+     */
+    bool parse( const char * data, int length );
+
+    /**
+     * @return whether the kernel reported @p field
+     */
+    bool has( quint64 MemInfo::*field ) const;
+
+    /**
+     * Generic access to all fields by index, in /proc/meminfo order
+     */
+    static int fieldCount();
+    static const char * fieldName( int field );
+    quint64 value( int field ) const;
+    bool has( int field ) const { return present & ( Q_UINT64_C( 1 ) << field ); }
+};
+
+/**
+ * zram swap and block devices, summed over /sys/block/zram* /mm_stat.
+ * Unlike zswap they don't show up in /proc/meminfo. Sizes in bytes.
+ */
+struct ZramInfo
+{
+    int devices;
+    quint64 origDataSize;       // uncompressed data stored
+    quint64 comprDataSize;      // the same, compressed
+    quint64 memUsedTotal;       // memory used, allocator overhead included
+
+    /**
+     * @return false if there is no zram device
+     */
+    bool read( const char * root = "/sys/block" );
+};
+
+#endif
@@ -0,0 +1,179 @@
+//////////////////////////////////////////////////////////////////////////
+// mounttable.cpp                                                       //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "mounttable.h"
+#include "procfs.h"
+
+#include <QFile>
+#include <QRegExp>
+
+#include <kdebug.h>
+#include <kstandarddirs.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @return the mountinfo field at @p p with its \ooo escapes decoded
+ */
+static QString unescape( const char * p, int length )
+{
+    QByteArray result;
+    result.reserve( length );
+    for ( const char * end = p + length; p < end; ++p )
+    {
+        if ( *p == '\\' && end - p >= 4 && p[1] >= '0' && p[1] <= '3' )
+        {
+            result += char( ( ( p[1] - '0' ) << 6 ) | ( ( p[2] - '0' ) << 3 ) | ( p[3] - '0' ) );
+            p += 3;
+        }
+        else
+            result += *p;
+    }
+    return QFile::decodeName( result );
+}
+
+/**
+ * Parse @p line, "id parent major:minor root mountpoint options
+ * [optional fields...] - fstype source superoptions"
+ */
+static bool parseEntry( const QByteArray & line, MountEntry & entry )
+{
+    const char * p = line.constData();
+    const char * const end = p + line.size();
+    const char * word;
+    int length;
+
+    // id, parent, major:minor, root, mount point
+    const char * fields[5];
+    int lengths[5];
+    for ( int i = 0; i < 5; ++i )
+    {
+        if ( !ProcFS::nextWord( p, end, word, length ) )
+            return false;
+        fields[i] = word;
+        lengths[i] = length;
+    }
+
+    // skip the options and the optional fields up to the separator
+    do
+    {
+        if ( !ProcFS::nextWord( p, end, word, length ) )
+            return false;
+    } while ( length != 1 || *word != '-' );
+
+    const char * fsType;
+    int fsTypeLength;
+    if ( !ProcFS::nextWord( p, end, fsType, fsTypeLength ) || !ProcFS::nextWord( p, end, word, length ) )
+        return false;
+
+    entry.id = ProcFS::toULong( fields[0], fields[0] + lengths[0] );
+    entry.mountPoint = unescape( fields[4], lengths[4] );
+    entry.fsType = QString::fromLatin1( fsType, fsTypeLength );
+    entry.device = unescape( word, length );
+    if ( entry.device.startsWith( QLatin1Char( '/' ) ) )
+        entry.device = KStandardDirs::realFilePath( entry.device );
+
+    // this is ugly workaround, should be in HAL but there is no LVM support
+    static const QRegExp rxlvm( "^/dev/mapper/\\S*-\\S*" );
+    entry.lvm = rxlvm.exactMatch( entry.device );
+    return true;
+}
+
+MountTable::MountTable()
+    : m_fd( -1 )
+{
+}
+
+MountTable::~MountTable()
+{
+    if ( m_fd >= 0 )
+        ::close( m_fd );
+}
+
+bool MountTable::update()
+{
+    if ( m_fd < 0 )
+    {
+        m_fd = ::open( "/proc/self/mountinfo", O_RDONLY | O_CLOEXEC );
+        if ( m_fd < 0 )
+        {
+            kDebug(1242) << "Can't open /proc/self/mountinfo:" << strerror( errno );
+            return false;
+        }
+    }
+    else
+    {
+        // the kernel flags a change with POLLPRI | POLLERR, once per change
+        struct pollfd pfd;
+        pfd.fd = m_fd;
+        pfd.events = POLLPRI;
+        pfd.revents = 0;
+        if ( ::poll( &pfd, 1, 0 ) <= 0 || !( pfd.revents & ( POLLPRI | POLLERR ) ) )
+            return false;
+        ::lseek( m_fd, 0, SEEK_SET );
+    }
+
+    if ( !ProcFS::readFd( m_fd, m_buffer ) )
+        return false;
+
+    return parse();
+}
+
+bool MountTable::parse()
+{
+    bool changed = false;
+    QMap<int, MountEntry> entries;
+
+    const char * p = m_buffer.constData();
+    const char * const end = p + m_buffer.size();
+    while ( p < end )
+    {
+        const char * eol = static_cast<const char *>( memchr( p, '\n', end - p ) );
+        if ( !eol )
+            eol = end;
+        const int id = ProcFS::toULong( p, eol );
+        const QByteArray line = QByteArray::fromRawData( p, eol - p );
+        p = eol + 1;
+
+        QMap<int, MountEntry>::ConstIterator old = m_entries.constFind( id );
+        if ( old != m_entries.constEnd() && old->line == line )
+        {
+            entries.insert( id, *old );
+            continue;
+        }
+
+        MountEntry entry;
+        entry.line = QByteArray( line.constData(), line.size() ); // detach from m_buffer
+        if ( !parseEntry( entry.line, entry ) )
+            continue;
+        entries.insert( id, entry );
+        changed = true;
+    }
+
+    if ( !changed && entries.size() == m_entries.size() )
+        return false;
+    m_entries = entries;
+    return true;
+}
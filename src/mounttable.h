@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////
+// mounttable.h                                                         //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _mounttable_H_
+#define _mounttable_H_
+
+#include <qbytearray.h>
+#include <qmap.h>
+#include <qstring.h>
+
+/**
+ * One line of /proc/self/mountinfo
+ */
+struct MountEntry
+{
+    int id;                 // mount ID, unique while mounted
+    QString mountPoint;
+    QString device;         // mount source, symlinks resolved
+    QString fsType;
+    bool lvm;               // LVM logical volume, which Solid doesn't list
+    QByteArray line;        // as read, to tell whether it changed
+};
+
+/**
+ * Long-lived index of the mount table, keyed by mount ID.
+ *
+ * /proc/self/mountinfo is kept open and only read again when poll() says
+ * the table changed. Entries whose line is the same as before are kept as
+ * they are, so symlinks are only resolved for mounts which are new.
+ * Not thread safe, meant to be owned by the slave.
+ */
+class MountTable
+{
+public:
+    MountTable();
+    ~MountTable();
+
+    /**
+     * Re-read the table if the kernel reported a change since the last call
+     * @return true if any entry was added, removed or changed
+     */
+    bool update();
+
+    /**
+     * @return the entries by mount ID, which follows mount order
+     */
+    const QMap<int, MountEntry> & entries() const { return m_entries; }
+
+private:
+    Q_DISABLE_COPY( MountTable )
+
+    /**
+     * @return true if an entry was added, removed or changed
+     */
+    bool parse();
+
+    int m_fd;
+    QByteArray m_buffer;
+    QMap<int, MountEntry> m_entries;
+};
+
+#endif
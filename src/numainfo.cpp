@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////
+// numainfo.cpp                                                         //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "numainfo.h"
+#include "procfs.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// in file order; the lines start with "Node N", skipped by the scanner
+static const ProcFS::Field<NumaNodeInfo> nodeMemInfoFields[] = {
+    { "MemTotal",       &NumaNodeInfo::memTotal },
+    { "MemFree",        &NumaNodeInfo::memFree },
+    { "FilePages",      &NumaNodeInfo::filePages },
+    { "AnonPages",      &NumaNodeInfo::anonPages }
+};
+
+static const ProcFS::Field<NumaNodeInfo> numaStatFields[] = {
+    { "numa_hit",       &NumaNodeInfo::numaHit },
+    { "numa_miss",      &NumaNodeInfo::numaMiss },
+    { "numa_foreign",   &NumaNodeInfo::numaForeign },
+    { "interleave_hit", &NumaNodeInfo::interleaveHit },
+    { "local_node",     &NumaNodeInfo::localNode },
+    { "other_node",     &NumaNodeInfo::otherNode }
+};
+
+bool NumaInfo::read( QVector<NumaNodeInfo> & nodes, const char * root )
+{
+    nodes.resize( 0 );
+
+    const int nodeDir = ::open( root, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    if ( nodeDir < 0 )
+        return false;
+
+    char buffer[4096];
+    QVector<int> online;
+    int length = ProcFS::readFileAt( nodeDir, "online", buffer, sizeof( buffer ) );
+    if ( length <= 0 || !ProcFS::parseList( buffer, buffer + length, online ) )
+    {
+        ::close( nodeDir );
+        return false;
+    }
+
+    nodes.resize( online.size() );
+    for ( int i = 0; i < online.size(); ++i )
+    {
+        NumaNodeInfo & info = nodes[i];
+        memset( &info, 0, sizeof( info ) );
+        info.node = online.at( i );
+
+        char path[64];
+        snprintf( path, sizeof( path ), "node%d/meminfo", info.node );
+        length = ProcFS::readFileAt( nodeDir, path, buffer, sizeof( buffer ) );
+        if ( length > 0 )
+            ProcFS::scanFields( buffer, length, nodeMemInfoFields,
+                                sizeof( nodeMemInfoFields ) / sizeof( *nodeMemInfoFields ), info, 2 );
+
+        snprintf( path, sizeof( path ), "node%d/numastat", info.node );
+        length = ProcFS::readFileAt( nodeDir, path, buffer, sizeof( buffer ) );
+        if ( length > 0 )
+            ProcFS::scanFields( buffer, length, numaStatFields,
+                                sizeof( numaStatFields ) / sizeof( *numaStatFields ), info );
+    }
+    ::close( nodeDir );
+    return true;
+}
@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////////////
+// numainfo.h                                                           //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _numainfo_H_
+#define _numainfo_H_
+
+#include <qglobal.h>
+#include <qvector.h>
+
+/**
+ * Memory of one NUMA node, from nodeN/meminfo and nodeN/numastat
+ */
+struct NumaNodeInfo
+{
+    int node;
+
+    // in KiB
+    quint64 memTotal;           // MemTotal
+    quint64 memFree;            // MemFree
+    quint64 filePages;          // FilePages
+    quint64 anonPages;          // AnonPages
+
+    // allocation counters since boot, in pages
+    quint64 numaHit;            // allocated here as intended
+    quint64 numaMiss;           // allocated here although another node was preferred
+    quint64 numaForeign;        // intended for here but allocated on another node
+    quint64 interleaveHit;      // interleave policy allocations which got this node
+    quint64 localNode;          // allocated here by a process running here
+    quint64 otherNode;          // allocated here by a process running elsewhere
+};
+
+/**
+ * Per-node memory breakdown from /sys/devices/system/node
+ */
+namespace NumaInfo
+{
+    /**
+     * Read all online nodes into @p nodes, reusing its capacity. Both files
+     * of a node are parsed in a single pass from a stack buffer, the same
+     * way as /proc/meminfo.
+     * @return false if the kernel has no NUMA support
+     */
+    bool read( QVector<NumaNodeInfo> & nodes, const char * root = "/sys/devices/system/node" );
+}
+
+#endif
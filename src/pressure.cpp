@@ -0,0 +1,191 @@
+//////////////////////////////////////////////////////////////////////////
+// pressure.cpp                                                         //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "pressure.h"
+#include "procfs.h"
+
+#include <QDataStream>
+
+#include <kdebug.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static const char * const s_paths[Pressure::RESOURCE_COUNT] = {
+    "/proc/pressure/cpu",
+    "/proc/pressure/memory",
+    "/proc/pressure/io"
+};
+
+const char * Pressure::resourceName( Resource resource )
+{
+    return s_paths[resource] + sizeof( "/proc/pressure/" ) - 1;
+}
+
+/*
+ * "some avg10=0.12 avg60=0.05 avg300=0.01 total=123456"
+ * "full avg10=0.00 avg60=0.00 avg300=0.00 total=6789"
+ */
+static void parseLine( const ProcFS::Line & line, PressureLine & result )
+{
+    static const char * const keys[3] = { "avg10=", "avg60=", "avg300=" };
+    int found = 0;
+    const char * p = line.value;
+    const char * word;
+    int length;
+    while ( ProcFS::nextWord( p, line.end, word, length ) )
+    {
+        for ( int i = 0; i < 3; ++i )
+        {
+            const int keyLength = strlen( keys[i] );
+            if ( length > keyLength && strncmp( word, keys[i], keyLength ) == 0 )
+            {
+                result.avg[i] = ProcFS::toFloat( word + keyLength, word + length );
+                ++found;
+            }
+        }
+        if ( length > 6 && strncmp( word, "total=", 6 ) == 0 )
+        {
+            result.total = ProcFS::toULong( word + 6, word + length );
+            ++found;
+        }
+    }
+    result.valid = found == 4;
+}
+
+bool Pressure::read( Resource resource, PressureStats & stats )
+{
+    memset( &stats, 0, sizeof( stats ) );
+
+    char buffer[256];
+    const int length = ProcFS::readFile( s_paths[resource], buffer, sizeof( buffer ) );
+    if ( length <= 0 )
+        return false;
+
+    ProcFS::Line line;
+    for ( const char * p = buffer; p && p < buffer + length; )
+    {
+        p = ProcFS::nextLine( p, buffer + length, line );
+        if ( ProcFS::keyIs( line, "some" ) )
+            parseLine( line, stats.some );
+        else if ( ProcFS::keyIs( line, "full" ) )
+            parseLine( line, stats.full );
+    }
+    return stats.some.valid;
+}
+
+PressureMonitor::PressureMonitor()
+{
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+        m_fds[i] = -1;
+}
+
+PressureMonitor::~PressureMonitor()
+{
+    disarm();
+}
+
+void PressureMonitor::disarm()
+{
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        if ( m_fds[i] >= 0 )
+            ::close( m_fds[i] );
+        m_fds[i] = -1;
+    }
+}
+
+bool PressureMonitor::arm( int stallMs, int windowMs )
+{
+    disarm();
+
+    // the trigger lives as long as the file stays open
+    char trigger[64];
+    const int length = snprintf( trigger, sizeof( trigger ), "some %d %d",
+                                 stallMs * 1000, windowMs * 1000 ) + 1;
+    bool armed = false;
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        const int fd = ::open( s_paths[i], O_RDWR | O_NONBLOCK | O_CLOEXEC );
+        if ( fd < 0 )
+            continue;
+        if ( ::write( fd, trigger, length ) < 0 )
+        {
+            kDebug(1242) << "Can't register a PSI trigger on" << s_paths[i] << ":" << strerror( errno );
+            ::close( fd );
+            continue;
+        }
+        m_fds[i] = fd;
+        armed = true;
+    }
+    return armed;
+}
+
+int PressureMonitor::fired()
+{
+    struct pollfd fds[Pressure::RESOURCE_COUNT];
+    int count = 0;
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        if ( m_fds[i] < 0 )
+            continue;
+        fds[count].fd = m_fds[i];
+        fds[count].events = POLLPRI;
+        fds[count].revents = 0;
+        ++count;
+    }
+    if ( !count || ::poll( fds, count, 0 ) <= 0 )
+        return 0;
+
+    int resources = 0;
+    for ( int i = 0, n = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        if ( m_fds[i] < 0 )
+            continue;
+        if ( fds[n++].revents & POLLPRI )
+            resources |= 1 << i;
+    }
+    return resources;
+}
+
+static QDataStream & operator<<( QDataStream & stream, const PressureLine & line )
+{
+    return stream << line.valid << line.avg[0] << line.avg[1] << line.avg[2] << line.total;
+}
+
+static QDataStream & operator>>( QDataStream & stream, PressureLine & line )
+{
+    return stream >> line.valid >> line.avg[0] >> line.avg[1] >> line.avg[2] >> line.total;
+}
+
+QDataStream & operator<<( QDataStream & stream, const PressureStats & stats )
+{
+    return stream << stats.some << stats.full;
+}
+
+QDataStream & operator>>( QDataStream & stream, PressureStats & stats )
+{
+    return stream >> stats.some >> stats.full;
+}
@@ -0,0 +1,131 @@
+//////////////////////////////////////////////////////////////////////////
+// pressure.h                                                           //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _pressure_H_
+#define _pressure_H_
+
+#include <qglobal.h>
+
+class QDataStream;
+
+// defaults for [Pressure] TriggerStall and TriggerWindow (ms) in kio_sysinforc:
+// a trigger fires when tasks were stalled for TriggerStall within TriggerWindow.
+// Windows have to be multiples of 2 s for unprivileged users.
+#define PRESSURE_STALL_MS 150
+#define PRESSURE_WINDOW_MS 2000
+
+/**
+ * One line of a /proc/pressure file
+ */
+struct PressureLine
+{
+    bool valid;
+    float avg[3];           // % of time stalled over the last 10 s, 60 s, 300 s
+    quint64 total;          // total stall time in microseconds
+};
+
+/**
+ * Pressure stall information of one resource. "some" is the share of time
+ * at least one task was stalled on the resource, "full" the share all
+ * non-idle tasks were stalled at the same time.
+ */
+struct PressureStats
+{
+    PressureLine some;
+    PressureLine full;      // not valid for the CPU on kernels before 5.13
+};
+
+/**
+ * Stream the stats, e.g. from the sampler daemon to a slave
+ */
+QDataStream & operator<<( QDataStream & stream, const PressureStats & stats );
+QDataStream & operator>>( QDataStream & stream, PressureStats & stats );
+
+/**
+ * Pressure stall information from /proc/pressure (Linux 4.20 and later,
+ * CONFIG_PSI)
+ */
+namespace Pressure
+{
+    enum Resource
+    {
+        Cpu = 0,
+        Memory,
+        Io,
+        RESOURCE_COUNT
+    };
+
+    /**
+     * @return the file name under /proc/pressure, also used in the JSON output
+     */
+    const char * resourceName( Resource resource );
+
+    /**
+     * Read the current averages of @p resource
+     * @return false if the kernel doesn't provide PSI
+     */
+    bool read( Resource resource, PressureStats & stats );
+}
+
+/**
+ * PSI triggers on all resources.
+ *
+ * The kernel signals POLLPRI on a trigger's file descriptor once per window
+ * in which the stall threshold was exceeded, so stalls are noticed as they
+ * happen instead of by polling the averages. The event stays pending until
+ * it is polled, a long-lived owner can thus also ask "did anything stall
+ * since I last looked" at no cost.
+ */
+class PressureMonitor
+{
+public:
+    PressureMonitor();
+    ~PressureMonitor();
+
+    /**
+     * Register a trigger for "some" stalls of @p stallMs within @p windowMs
+     * on every resource, replacing previous triggers
+     * @return false if no trigger could be registered
+     */
+    bool arm( int stallMs, int windowMs );
+
+    void disarm();
+
+    /**
+     * @return the file descriptor to watch for POLLPRI (exceptions for
+     * select() and QSocketNotifier), -1 if @p resource has no trigger
+     */
+    int fd( Pressure::Resource resource ) const { return m_fds[resource]; }
+
+    /**
+     * Consume pending events without blocking
+     * @return bitmask of the resources (1 << Pressure::Resource) whose
+     * trigger fired since the previous call
+     */
+    int fired();
+
+private:
+    Q_DISABLE_COPY( PressureMonitor )
+
+    int m_fds[Pressure::RESOURCE_COUNT];
+};
+
+#endif
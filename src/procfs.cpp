@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////////////
+// procfs.cpp                                                           //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "procfs.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+
+bool ProcFS::readFile( const char * path, QByteArray & buffer )
+{
+    const int fd = ::open( path, O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 )
+        return false;
+
+    const bool ok = readFd( fd, buffer );
+    ::close( fd );
+    return ok;
+}
+
+bool ProcFS::readFd( int fd, QByteArray & buffer )
+{
+    if ( buffer.capacity() < 4096 )
+        buffer.reserve( 4096 );
+    buffer.resize( buffer.capacity() );
+
+    int size = 0;
+    for ( ;; )
+    {
+        if ( size == buffer.size() )
+            buffer.resize( buffer.size() * 2 );
+
+        const ssize_t n = ::read( fd, buffer.data() + size, buffer.size() - size );
+        if ( n < 0 && errno == EINTR )
+            continue;
+        if ( n < 0 )
+        {
+            buffer.clear();
+            return false;
+        }
+        if ( n == 0 )
+            break;
+        size += n;
+    }
+
+    buffer.resize( size );
+    return true;
+}
+
+int ProcFS::readFile( const char * path, char * buffer, int size )
+{
+    return readFileAt( AT_FDCWD, path, buffer, size );
+}
+
+int ProcFS::readFileAt( int dirfd, const char * path, char * buffer, int size )
+{
+    const int fd = ::openat( dirfd, path, O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 )
+        return -1;
+
+    ssize_t n;
+    do
+        n = ::read( fd, buffer, size - 1 );
+    while ( n < 0 && errno == EINTR );
+    ::close( fd );
+
+    if ( n < 0 )
+        return -1;
+    buffer[n] = '\0';
+    return n;
+}
+
+static inline bool isBlank( char c )
+{
+    return c == ' ' || c == '\t';
+}
+
+const char * ProcFS::nextLine( const char * p, const char * end, Line & line, int skipWords )
+{
+    const char * eol = static_cast<const char *>( memchr( p, '\n', end - p ) );
+    if ( !eol )
+        eol = end;
+
+    line.end = eol;
+    for ( ; skipWords > 0 && p < eol; --skipWords )
+    {
+        while ( p < eol && isBlank( *p ) )
+            ++p;
+        while ( p < eol && !isBlank( *p ) )
+            ++p;
+    }
+    while ( p < eol && isBlank( *p ) )
+        ++p;
+
+    // the key ends at the colon, or at the first blank if there is none
+    line.key = p;
+    while ( p < eol && *p != ':' && !isBlank( *p ) )
+        ++p;
+    line.keyLength = p - line.key;
+    while ( p < eol && ( *p == ':' || isBlank( *p ) ) )
+        ++p;
+    line.value = p;
+
+    return eol < end ? eol + 1 : 0;
+}
+
+quint64 ProcFS::toULong( const char * p, const char * end )
+{
+    while ( p < end && isBlank( *p ) )
+        ++p;
+    quint64 value = 0;
+    for ( ; p < end && *p >= '0' && *p <= '9'; ++p )
+        value = value * 10 + ( *p - '0' );
+    return value;
+}
+
+float ProcFS::toFloat( const char * p, const char * end )
+{
+    while ( p < end && isBlank( *p ) )
+        ++p;
+    float value = 0;
+    for ( ; p < end && *p >= '0' && *p <= '9'; ++p )
+        value = value * 10 + ( *p - '0' );
+    if ( p < end && *p == '.' )
+    {
+        float scale = 1;
+        for ( ++p; p < end && *p >= '0' && *p <= '9'; ++p )
+        {
+            scale /= 10;
+            value += ( *p - '0' ) * scale;
+        }
+    }
+    return value;
+}
+
+bool ProcFS::nextWord( const char * & p, const char * end, const char * & word, int & length )
+{
+    while ( p < end && ( isBlank( *p ) || *p == '\n' ) )
+        ++p;
+    word = p;
+    while ( p < end && !isBlank( *p ) && *p != '\n' )
+        ++p;
+    length = p - word;
+    return length > 0;
+}
+
+bool ProcFS::keyIs( const Line & line, const char * key )
+{
+    return strncmp( line.key, key, line.keyLength ) == 0 && key[line.keyLength] == '\0';
+}
+
+bool ProcFS::parseList( const char * p, const char * end, QVector<int> & items )
+{
+    items.resize( 0 );
+    while ( p < end && !isBlank( *p ) && *p != '\n' )
+    {
+        if ( *p < '0' || *p > '9' )
+            return false;
+        const int first = toULong( p, end );
+        while ( p < end && *p >= '0' && *p <= '9' )
+            ++p;
+        int last = first;
+        if ( p < end && *p == '-' )
+        {
+            last = toULong( ++p, end );
+            while ( p < end && *p >= '0' && *p <= '9' )
+                ++p;
+        }
+        for ( int i = first; i <= last; ++i )
+            items.append( i );
+        if ( p < end && *p == ',' )
+            ++p;
+    }
+    return true;
+}
@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////
+// procfs.h                                                             //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _procfs_H_
+#define _procfs_H_
+
+#include <qbytearray.h>
+#include <qglobal.h>
+#include <qvector.h>
+
+/**
+ * Helpers for reading procfs and sysfs files.
+ *
+ * These files report a size of 0 and are generated by the kernel on every
+ * open(), so they are read in one go with plain read(2) calls instead of
+ * going through QFile/QTextStream line by line.
+ */
+namespace ProcFS
+{
+    /**
+     * Read the whole file @p path into @p buffer, reusing its capacity
+     * @return false if the file can't be opened or read
+     */
+    bool readFile( const char * path, QByteArray & buffer );
+
+    /**
+     * Same as above for an already open @p fd, read from its current offset
+     */
+    bool readFd( int fd, QByteArray & buffer );
+
+    /**
+     * Read @p path with a single read(2) into the caller provided @p buffer,
+     * for small files like /proc/meminfo which don't need to be on the heap.
+     * The result is NUL terminated.
+     * @return the number of bytes read or -1 on error
+     */
+    int readFile( const char * path, char * buffer, int size );
+
+    /**
+     * Same as above with @p path relative to the open directory @p dirfd,
+     * for reading many attributes of one sysfs directory without resolving
+     * the whole path every time
+     */
+    int readFileAt( int dirfd, const char * path, char * buffer, int size );
+
+    /**
+     * One tokenized "key: value" or "key value" line, pointing into the
+     * scanned buffer
+     */
+    struct Line
+    {
+        const char * key;
+        int keyLength;
+        const char * value;     // first non-blank after the key
+        const char * end;       // end of the line
+    };
+
+    /**
+     * Tokenize the line starting at @p p, skipping @p skipWords leading
+     * words first (e.g. 2 for the "Node 0" prefix in the per-node meminfo)
+     * @return the start of the next line, 0 if there's none left
+     */
+    const char * nextLine( const char * p, const char * end, Line & line, int skipWords = 0 );
+
+    /**
+     * Parse the unsigned decimal number at the start of [@p p, @p end),
+     * leading blanks are skipped, anything after the digits is ignored
+     */
+    quint64 toULong( const char * p, const char * end );
+
+    /**
+     * Same for a number with an optional fraction, "2394.123". Always
+     * with a dot, unlike strtod() which goes by LC_NUMERIC.
+     */
+    float toFloat( const char * p, const char * end );
+
+    /**
+     * Advance @p p past the next blank separated word in [@p p, @p end)
+     * @return false if there is no word left
+     */
+    bool nextWord( const char * & p, const char * end, const char * & word, int & length );
+
+    bool keyIs( const Line & line, const char * key );
+
+    /**
+     * Parse a list like "0-3,8,10-11" (cpulist, node lists) into @p items
+     * @return false if it's malformed
+     */
+    bool parseList( const char * p, const char * end, QVector<int> & items );
+
+    /**
+     * Maps a key to the quint64 member of @p T it gets stored in
+     */
+    template <typename T>
+    struct Field
+    {
+        const char * key;
+        quint64 T::*member;
+    };
+
+    /**
+     * Scan key/value lines in a single pass, storing the numeric value of
+     * every key listed in @p fields into the matching member of @p record.
+     *
+     * The search for a key starts after the previously matched field, so
+     * a table in file order costs one comparison per line.
+     * @return bitmask of the fields found, by index in @p fields (max. 64)
+     */
+    template <typename T>
+    quint64 scanFields( const char * data, int length, const Field<T> * fields, int count,
+                        T & record, int skipWords = 0 )
+    {
+        quint64 found = 0;
+        int hint = 0;
+        Line line;
+        const char * const end = data + length;
+        for ( const char * p = data; p && p < end; )
+        {
+            p = nextLine( p, end, line, skipWords );
+            if ( !line.keyLength )
+                continue;
+            for ( int n = 0; n < count; ++n )
+            {
+                const int i = ( hint + n ) % count;
+                if ( keyIs( line, fields[i].key ) )
+                {
+                    record.*( fields[i].member ) = toULong( line.value, line.end );
+                    found |= Q_UINT64_C( 1 ) << i;
+                    hint = i + 1;
+                    break;
+                }
+            }
+        }
+        return found;
+    }
+}
+
+#endif
@@ -0,0 +1,200 @@
+//////////////////////////////////////////////////////////////////////////
+// sampler.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+/*
+ * kio_sysinfo_sampler: keeps the collectors running and publishes their
+ * snapshot for the slaves, along with the CPU load, frequencies, sensors,
+ * pressure and the usage history, see SharedSnapshot and SamplerData.
+ *
+ * Started by the part if [Sampler] Autostart is set in kio_sysinforc, with
+ * --idle-exit so it goes away once nobody looks, or as a user service.
+ * With [Log] Enabled it also appends a snapshot to the log every [Log]
+ * Interval, see SnapshotLog.
+ */
+
+#include "sysinfo.h"
+#include "history.h"
+#include "mounttable.h"
+#include "samplerdata.h"
+#include "sharedsnapshot.h"
+#include "snapshotlog.h"
+
+#include <QCoreApplication>
+#include <QMutex>
+#include <QRunnable>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTime>
+
+#include <kcomponentdata.h>
+#include <kconfiggroup.h>
+#include <kdebug.h>
+#include <kglobal.h>
+
+#include <unistd.h>
+
+// defaults for [Sampler] in kio_sysinforc: ms between snapshots, s between
+// runs of the slow collectors, s without readers before --idle-exit quits
+#define SAMPLER_INTERVAL_MS 1000
+#define SAMPLER_SLOW_INTERVAL_S 300
+#define SAMPLER_IDLE_TIMEOUT_S 600
+
+/*
+ * Mount points of block devices, whose usage the history keeps
+ */
+static QStringList diskMountPoints( const MountTable & mounts )
+{
+    QStringList mountPoints;
+    Q_FOREACH ( const MountEntry & entry, mounts.entries() )
+    {
+        if ( entry.device.startsWith( "/dev/" ) && !mountPoints.contains( entry.mountPoint ) )
+            mountPoints << entry.mountPoint;
+    }
+    return mountPoints;
+}
+
+/*
+ * The latest results of the slow collectors
+ */
+struct SlowResults
+{
+    QMutex lock;                // guards everything below
+    SysInfoSnapshot info;
+    int results;
+    bool running;
+};
+
+/*
+ * One run of the slow collectors. It happens on a thread of its own, as a
+ * popen() or GL query taking seconds would otherwise hold up the snapshots
+ * long enough for the slaves to take them as stale.
+ */
+class SlowTask : public QRunnable
+{
+public:
+    SlowTask( SlowResults & slow, int which )
+        : m_slow( slow ), m_which( which ) {}
+
+    void run()
+    {
+        SysInfoSnapshot info;
+        info.clear();
+        const int results = kio_sysinfoProtocol::collect( info, m_which );
+
+        QMutexLocker locker( &m_slow.lock );
+        m_slow.info = info;
+        m_slow.results = results;
+        m_slow.running = false;
+    }
+
+private:
+    SlowResults & m_slow;
+    const int m_which;
+};
+
+int main( int argc, char **argv )
+{
+    KComponentData componentData( "kio_sysinfo" );
+    QCoreApplication app( argc, argv );
+
+    const KConfigGroup cg( KGlobal::config(), "Sampler" );
+    const int interval = qMax( 100, cg.readEntry( "Interval", SAMPLER_INTERVAL_MS ) );
+    const int slowInterval = cg.readEntry( "SlowInterval", SAMPLER_SLOW_INTERVAL_S ) * 1000;
+    const qint64 idleTimeout = app.arguments().contains( "--idle-exit" ) ?
+                               qint64( cg.readEntry( "IdleTimeout", SAMPLER_IDLE_TIMEOUT_S ) ) * 1000 : 0;
+
+    SharedSnapshot shared;
+    if ( !shared.openWriter( interval ) )
+    {
+        kDebug(1242) << "Another sampler is running already";
+        return 0;
+    }
+
+    // what's fast to gather is gathered on every round, the slow ones
+    // (OpenGL, KDE versions, OS) only every slowInterval
+    const int fast = ( 1 << kio_sysinfoProtocol::COLL_CPU ) | ( 1 << kio_sysinfoProtocol::COLL_MEMORY );
+    const int slow = ( ( 1 << kio_sysinfoProtocol::COLL_COUNT ) - 1 ) & ~fast;
+
+    qint64 logInterval = 0;
+    qint64 lastLogged = 0;
+    SnapshotLog * log = kio_sysinfoProtocol::createLog( logInterval );
+    History * history = kio_sysinfoProtocol::createHistory();
+    MountTable mounts;
+
+    // leaked on purpose, ~QThreadPool() would wait for a hung collector,
+    // which may still write its results on the way out
+    QThreadPool * slowPool = new QThreadPool;
+    slowPool->setMaxThreadCount( 1 );
+    SlowResults & slowResults = *new SlowResults;
+    slowResults.info.clear();
+    slowResults.results = 0;
+    slowResults.running = false;
+    QTime slowAge;
+    SysInfoSnapshot info;
+    SamplerData sampled;
+    for ( ;; )
+    {
+        QTime round;
+        round.start();
+
+        // until the first slow run is done the snapshots go without them
+        int results;
+        {
+            QMutexLocker locker( &slowResults.lock );
+            if ( !slowResults.running && ( slowAge.isNull() || slowAge.elapsed() >= slowInterval ) )
+            {
+                slowResults.running = true;
+                slowPool->start( new SlowTask( slowResults, slow ) );
+                slowAge.start();
+            }
+            info = slowResults.info;
+            results = slowResults.results;
+        }
+
+        results |= kio_sysinfoProtocol::collect( info, fast );
+        if ( history && mounts.update() )
+            history->setMountPoints( diskMountPoints( mounts ) );
+        sampled.sample();
+        sampled.takeHistory( history );
+        shared.publish( info, results, sampled.save() );
+
+        const qint64 now = SnapshotLog::now();
+        if ( log && qAbs( now - lastLogged ) >= logInterval )
+        {
+            log->append( info, results, now );
+            lastLogged = now;
+        }
+
+        if ( idleTimeout && shared.idleTime() > idleTimeout )
+        {
+            kDebug(1242) << "No readers for" << idleTimeout / 1000 << "s, exiting";
+            break;
+        }
+
+        const int remaining = interval - round.elapsed();
+        if ( remaining > 0 )
+            usleep( remaining * 1000 );
+    }
+
+    delete history;
+    delete log;
+    return 0;
+}
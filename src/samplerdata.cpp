@@ -0,0 +1,102 @@
+//////////////////////////////////////////////////////////////////////////
+// samplerdata.cpp                                                      //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "samplerdata.h"
+
+#include <QDataStream>
+
+// bumped whenever the streamed layout changes
+#define SAMPLER_DATA_VERSION 2
+
+SamplerData::SamplerData()
+    : historyMinutes( 0 )
+{
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+        havePressure[i] = false;
+}
+
+void SamplerData::sample()
+{
+    cpuStat.sample();
+    freq.read();
+    sensors = Sensors::system().read();
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+        havePressure[i] = Pressure::read( Pressure::Resource( i ), pressure[i] );
+}
+
+void SamplerData::takeHistory( const History * source )
+{
+    historyMinutes = source ? source->minutes() : 0;
+    for ( int i = 0; i < History::METRIC_COUNT; ++i )
+    {
+        if ( source )
+            source->series( History::Metric( i ) ).points( history[i] );
+        else
+            history[i].clear();
+    }
+    diskHistory.clear();
+    if ( source )
+    {
+        Q_FOREACH ( const QString & mountPoint, source->disks() )
+            source->disk( mountPoint )->points( diskHistory[mountPoint] );
+    }
+}
+
+QByteArray SamplerData::save() const
+{
+    QByteArray data;
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream << qint32( SAMPLER_DATA_VERSION ) << cpuStat << freq << sensors;
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        stream << havePressure[i];
+        if ( havePressure[i] )
+            stream << pressure[i];
+    }
+    stream << qint32( historyMinutes );
+    for ( int i = 0; i < History::METRIC_COUNT; ++i )
+        stream << history[i];
+    stream << diskHistory;
+    return data;
+}
+
+bool SamplerData::load( const QByteArray & data )
+{
+    QDataStream stream( data );
+    qint32 version;
+    stream >> version;
+    if ( version != SAMPLER_DATA_VERSION )
+        return false;
+    stream >> cpuStat >> freq >> sensors;
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        stream >> havePressure[i];
+        if ( havePressure[i] )
+            stream >> pressure[i];
+    }
+    qint32 minutes;
+    stream >> minutes;
+    historyMinutes = minutes;
+    for ( int i = 0; i < History::METRIC_COUNT; ++i )
+        stream >> history[i];
+    stream >> diskHistory;
+    return stream.status() == QDataStream::Ok;
+}
@@ -0,0 +1,75 @@
+//////////////////////////////////////////////////////////////////////////
+// samplerdata.h                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _samplerdata_H_
+#define _samplerdata_H_
+
+#include <qbytearray.h>
+#include <qhash.h>
+#include <qvector.h>
+
+#include "cpufreq.h"
+#include "cpustat.h"
+#include "history.h"
+#include "pressure.h"
+#include "sensors.h"
+
+/**
+ * What the sampler daemon measures besides the snapshot fields: CPU load,
+ * frequencies, sensors, pressure and the History points. Published next
+ * to the snapshot, so that a slave renders them without reading /proc and
+ * /sys itself. Its size depends on the machine, so it's streamed with
+ * QDataStream rather than kept flat like SysInfoSnapshot.
+ */
+struct SamplerData
+{
+    SamplerData();
+
+    /**
+     * Read everything again. The load is the one since the previous call.
+     */
+    void sample();
+
+    /**
+     * Copy the points of @p source, or drop them if it's 0
+     */
+    void takeHistory( const History * source );
+
+    QByteArray save() const;
+
+    /**
+     * Replace the contents with @p data, as returned by save()
+     * @return false if it's corrupt or of another version
+     */
+    bool load( const QByteArray & data );
+
+    CpuStat cpuStat;
+    CpuFreq freq;                   // no policies without cpufreq
+    QVector<SensorReading> sensors;
+    PressureStats pressure[Pressure::RESOURCE_COUNT];
+    bool havePressure[Pressure::RESOURCE_COUNT];
+
+    int historyMinutes;             // 0 without history
+    QVector<qint64> history[History::METRIC_COUNT];
+    QHash<QString, QVector<qint64> > diskHistory;   // by mount point
+};
+
+#endif
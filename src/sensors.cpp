@@ -0,0 +1,247 @@
+//////////////////////////////////////////////////////////////////////////
+// sensors.cpp                                                          //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "sensors.h"
+#include "procfs.h"
+
+#include <QDataStream>
+#include <QList>
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define HWMON_DIR "/sys/class/hwmon"
+#define THERMAL_DIR "/sys/class/thermal"
+
+/**
+ * @return the contents of attribute @p name below @p dirfd, without the newline
+ */
+static QByteArray readAttribute( int dirfd, const char * name )
+{
+    char buffer[256];
+    const int length = ProcFS::readFileAt( dirfd, name, buffer, sizeof( buffer ) );
+    if ( length <= 0 )
+        return QByteArray();
+    return QByteArray( buffer, length ).trimmed();
+}
+
+Sensors::Sensors()
+{
+    scan();
+}
+
+Sensors::~Sensors()
+{
+    for ( int i = 0; i < m_sensors.size(); ++i )
+        ::close( m_sensors.at( i ).fd );
+}
+
+Sensors & Sensors::system()
+{
+    static Sensors * sensors = 0;
+    static QMutex mutex;
+    QMutexLocker locker( &mutex );
+    if ( !sensors )
+        sensors = new Sensors;
+    return *sensors;
+}
+
+void Sensors::add( int dirfd, const char * input, const QByteArray & chip, const QByteArray & label,
+                   SensorReading::Kind kind )
+{
+    Sensor sensor;
+    sensor.fd = ::openat( dirfd, input, O_RDONLY | O_CLOEXEC );
+    if ( sensor.fd < 0 )
+        return;
+    sensor.reading.chip = chip;
+    sensor.reading.label = label;
+    sensor.reading.kind = kind;
+    sensor.reading.value = 0;
+    m_sensors.append( sensor );
+}
+
+/*
+ * hwmonN/{temp,fan}M_input, with an optional {temp,fan}M_label. Older
+ * drivers have their attributes in hwmonN/device instead.
+ */
+void Sensors::scanHwmon( int dirfd, const QByteArray & chip )
+{
+    static const struct { const char * prefix; SensorReading::Kind kind; } types[] = {
+        { "temp", SensorReading::Temperature },
+        { "fan", SensorReading::Fan }
+    };
+
+    char input[64], label[64];
+    for ( unsigned t = 0; t < sizeof( types ) / sizeof( *types ); ++t )
+    {
+        // the indices may have gaps, coretemp starts at 2 on some machines
+        int misses = 0;
+        for ( int i = 1; misses < 8; ++i )
+        {
+            snprintf( input, sizeof( input ), "%s%d_input", types[t].prefix, i );
+            if ( faccessat( dirfd, input, R_OK, 0 ) != 0 )
+            {
+                ++misses;
+                continue;
+            }
+            misses = 0;
+            snprintf( label, sizeof( label ), "%s%d_label", types[t].prefix, i );
+            QByteArray name = readAttribute( dirfd, label );
+            if ( name.isEmpty() )
+                name = QByteArray( input, strlen( input ) - 6 );
+            add( dirfd, input, chip, name, types[t].kind );
+        }
+    }
+}
+
+void Sensors::scan()
+{
+    QList<QByteArray> chips;
+
+    DIR * dir = opendir( HWMON_DIR );
+    if ( dir )
+    {
+        while ( struct dirent * entry = readdir( dir ) )
+        {
+            if ( strncmp( entry->d_name, "hwmon", 5 ) != 0 )
+                continue;
+            const int hwmon = ::openat( ::dirfd( dir ), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+            if ( hwmon < 0 )
+                continue;
+
+            QByteArray chip = readAttribute( hwmon, "name" );
+            int attributes = hwmon;
+            if ( chip.isEmpty() )
+            {
+                attributes = ::openat( hwmon, "device", O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+                chip = attributes < 0 ? QByteArray() : readAttribute( attributes, "name" );
+            }
+            if ( !chip.isEmpty() )
+            {
+                chips << chip;
+                scanHwmon( attributes, chip );
+            }
+            if ( attributes >= 0 && attributes != hwmon )
+                ::close( attributes );
+            ::close( hwmon );
+        }
+        closedir( dir );
+    }
+
+    // thermal zones which aren't registered as hwmon devices as well
+    dir = opendir( THERMAL_DIR );
+    if ( dir )
+    {
+        while ( struct dirent * entry = readdir( dir ) )
+        {
+            if ( strncmp( entry->d_name, "thermal_zone", 12 ) != 0 )
+                continue;
+            const int zone = ::openat( ::dirfd( dir ), entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+            if ( zone < 0 )
+                continue;
+            const QByteArray type = readAttribute( zone, "type" );
+            if ( !type.isEmpty() && !chips.contains( type ) )
+                add( zone, "temp", "thermal", type, SensorReading::Temperature );
+            ::close( zone );
+        }
+        closedir( dir );
+    }
+}
+
+QVector<SensorReading> Sensors::read()
+{
+    QMutexLocker locker( &m_mutex );
+    QVector<SensorReading> readings;
+    readings.reserve( m_sensors.size() );
+
+    char buffer[32];
+    for ( int i = 0; i < m_sensors.size(); ++i )
+    {
+        Sensor & sensor = m_sensors[i];
+        ssize_t n;
+        do
+            n = ::pread( sensor.fd, buffer, sizeof( buffer ) - 1, 0 );
+        while ( n < 0 && errno == EINTR );
+        // sensors which are powered down fail with EAGAIN/ENODATA, skip them
+        if ( n <= 0 )
+            continue;
+        buffer[n] = '\0';
+        sensor.reading.value = strtoll( buffer, 0, 10 );
+        readings.append( sensor.reading );
+    }
+    return readings;
+}
+
+bool Sensors::isCpu( const SensorReading & reading )
+{
+    static const char * const chips[] = { "coretemp", "k10temp", "k8temp", "zenpower", "cpu_thermal", "cpu-thermal" };
+    for ( unsigned i = 0; i < sizeof( chips ) / sizeof( *chips ); ++i )
+    {
+        if ( reading.chip == chips[i] )
+            return true;
+    }
+    return reading.chip == "thermal" && ( reading.label == "x86_pkg_temp" || reading.label.startsWith( "cpu" ) );
+}
+
+int Sensors::cpuTemperature( const QVector<SensorReading> & readings )
+{
+    // by preference: Intel package, AMD control temperature, any CPU sensor,
+    // the ACPI zone
+    static const char * const labels[] = { "Package id 0", "Tctl", "Tdie" };
+    for ( unsigned l = 0; l < sizeof( labels ) / sizeof( *labels ); ++l )
+    {
+        for ( int i = 0; i < readings.size(); ++i )
+        {
+            if ( readings.at( i ).kind == SensorReading::Temperature && isCpu( readings.at( i ) ) &&
+                 readings.at( i ).label == labels[l] )
+                return i;
+        }
+    }
+    for ( int i = 0; i < readings.size(); ++i )
+    {
+        if ( readings.at( i ).kind == SensorReading::Temperature && isCpu( readings.at( i ) ) )
+            return i;
+    }
+    for ( int i = 0; i < readings.size(); ++i )
+    {
+        if ( readings.at( i ).kind == SensorReading::Temperature && readings.at( i ).chip == "acpitz" )
+            return i;
+    }
+    return -1;
+}
+
+QDataStream & operator<<( QDataStream & stream, const SensorReading & reading )
+{
+    return stream << reading.chip << reading.label << qint32( reading.kind ) << reading.value;
+}
+
+QDataStream & operator>>( QDataStream & stream, SensorReading & reading )
+{
+    qint32 kind;
+    stream >> reading.chip >> reading.label >> kind >> reading.value;
+    reading.kind = SensorReading::Kind( kind );
+    return stream;
+}
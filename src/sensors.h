@@ -0,0 +1,105 @@
+//////////////////////////////////////////////////////////////////////////
+// sensors.h                                                            //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _sensors_H_
+#define _sensors_H_
+
+#include <qbytearray.h>
+#include <qmutex.h>
+#include <qvector.h>
+
+class QDataStream;
+
+/**
+ * Current value of one hardware sensor
+ */
+struct SensorReading
+{
+    enum Kind
+    {
+        Temperature = 0,    // value in millidegrees Celsius
+        Fan                 // value in RPM
+    };
+
+    QByteArray chip;        // hwmon name, or "thermal" for thermal zones
+    QByteArray label;       // e.g. "Package id 0", "Core 3", "fan1"
+    Kind kind;
+    qint64 value;
+};
+
+/**
+ * Stream a reading, e.g. from the sampler daemon to a slave
+ */
+QDataStream & operator<<( QDataStream & stream, const SensorReading & reading );
+QDataStream & operator>>( QDataStream & stream, SensorReading & reading );
+
+/**
+ * Temperature and fan sensors from /sys/class/hwmon and /sys/class/thermal.
+ *
+ * The sensors are enumerated once and their value files kept open, a
+ * refresh is then one pread() per sensor. Thermal zones which also show
+ * up as a hwmon device are only listed once.
+ */
+class Sensors
+{
+public:
+    /**
+     * @return the sensors of this machine, enumerated on first use
+     */
+    static Sensors & system();
+
+    /**
+     * Re-read every sensor. Thread safe.
+     */
+    QVector<SensorReading> read();
+
+    /**
+     * @return whether @p reading belongs to the CPU (coretemp, k10temp, ...)
+     */
+    static bool isCpu( const SensorReading & reading );
+
+    /**
+     * @return the index in @p readings of the best guess at the CPU
+     * package temperature, -1 if there's none
+     */
+    static int cpuTemperature( const QVector<SensorReading> & readings );
+
+private:
+    Sensors();
+    ~Sensors();
+    Q_DISABLE_COPY( Sensors )
+
+    void scan();
+    void scanHwmon( int dirfd, const QByteArray & chip );
+    void add( int dirfd, const char * input, const QByteArray & chip, const QByteArray & label,
+              SensorReading::Kind kind );
+
+    struct Sensor
+    {
+        SensorReading reading;
+        int fd;
+    };
+
+    QMutex m_mutex;
+    QVector<Sensor> m_sensors;
+};
+
+#endif
@@ -0,0 +1,226 @@
+//////////////////////////////////////////////////////////////////////////
+// sharedsnapshot.cpp                                                   //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "sharedsnapshot.h"
+
+#include <kdebug.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SEGMENT_MAGIC 0x6b736e70    // "ksnp"
+#define SEGMENT_VERSION 2
+
+// room for SamplerData, only the pages written to take memory
+#define DATA_SIZE ( 1024 * 1024 )
+
+// a reader gives up on a snapshot the writer should have replaced this often
+#define STALE_INTERVALS 3
+
+struct SharedSnapshot::Segment
+{
+    quint32 magic;
+    quint32 version;
+    quint32 size;                   // sizeof( SysInfoSnapshot ) of the writer
+    quint32 interval;               // ms between snapshots
+    volatile quint32 sequence;      // odd while the writer is updating
+    qint32 results;                 // collectors which succeeded
+    volatile qint64 published;      // CLOCK_MONOTONIC ms of the last update
+    volatile qint64 lastRead;       // the same, of the last successful read
+    SysInfoSnapshot snapshot;
+    quint32 dataSize;               // bytes used in data
+    char data[DATA_SIZE];           // SamplerData::save()
+};
+
+static qint64 monotonicMs()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return qint64( ts.tv_sec ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void segmentName( char * name, int size )
+{
+    snprintf( name, size, "/kio_sysinfo-%d", int( getuid() ) );
+}
+
+SharedSnapshot::SharedSnapshot()
+    : m_segment( 0 ), m_fd( -1 )
+{
+}
+
+SharedSnapshot::~SharedSnapshot()
+{
+    close();
+}
+
+void SharedSnapshot::close()
+{
+    if ( m_segment )
+        munmap( m_segment, sizeof( Segment ) );
+    if ( m_fd >= 0 )
+        ::close( m_fd );    // drops the writer lock too
+    m_segment = 0;
+    m_fd = -1;
+}
+
+bool SharedSnapshot::openWriter( int interval )
+{
+    close();
+
+    char name[64];
+    segmentName( name, sizeof( name ) );
+    m_fd = shm_open( name, O_RDWR | O_CREAT | O_CLOEXEC, 0600 );
+    if ( m_fd < 0 )
+    {
+        kDebug(1242) << "Can't create" << name << ":" << strerror( errno );
+        return false;
+    }
+    if ( flock( m_fd, LOCK_EX | LOCK_NB ) < 0 )
+    {
+        close();
+        return false;
+    }
+
+    // never shrink it, a reader may have mapped it from a newer writer
+    struct stat st;
+    if ( fstat( m_fd, &st ) < 0 || ( st.st_size < off_t( sizeof( Segment ) ) && ftruncate( m_fd, sizeof( Segment ) ) < 0 ) )
+    {
+        close();
+        return false;
+    }
+
+    void * map = mmap( 0, sizeof( Segment ), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+    if ( map == MAP_FAILED )
+    {
+        close();
+        return false;
+    }
+    m_segment = static_cast<Segment *>( map );
+
+    // nothing valid yet: even sequence, but never published
+    m_segment->sequence = 0;
+    m_segment->published = 0;
+    m_segment->lastRead = monotonicMs();
+    m_segment->interval = interval;
+    m_segment->size = sizeof( SysInfoSnapshot );
+    m_segment->version = SEGMENT_VERSION;
+    __sync_synchronize();
+    m_segment->magic = SEGMENT_MAGIC;
+    return true;
+}
+
+bool SharedSnapshot::openReader()
+{
+    close();
+
+    char name[64];
+    segmentName( name, sizeof( name ) );
+    m_fd = shm_open( name, O_RDWR | O_CLOEXEC, 0 );
+    if ( m_fd < 0 )
+        return false;
+
+    // mapping past the end of the file would fault on access
+    struct stat st;
+    if ( fstat( m_fd, &st ) < 0 || st.st_size < off_t( sizeof( Segment ) ) )
+    {
+        close();
+        return false;
+    }
+
+    void * map = mmap( 0, sizeof( Segment ), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+    if ( map == MAP_FAILED )
+    {
+        close();
+        return false;
+    }
+    m_segment = static_cast<Segment *>( map );
+    return true;
+}
+
+void SharedSnapshot::publish( const SysInfoSnapshot & snapshot, int results, const QByteArray & data )
+{
+    Segment * const segment = m_segment;
+    if ( data.size() > DATA_SIZE )
+        kDebug(1242) << "Sampler data of" << data.size() << "bytes doesn't fit, dropped";
+    const int dataSize = data.size() > DATA_SIZE ? 0 : data.size();
+
+    ++segment->sequence;
+    __sync_synchronize();
+    segment->snapshot = snapshot;
+    segment->results = results;
+    memcpy( segment->data, data.constData(), dataSize );
+    segment->dataSize = dataSize;
+    segment->published = monotonicMs();
+    __sync_synchronize();
+    ++segment->sequence;
+}
+
+bool SharedSnapshot::read( SysInfoSnapshot & snapshot, int & results, QByteArray & data )
+{
+    Segment * const segment = m_segment;
+    if ( !segment || segment->magic != SEGMENT_MAGIC || segment->version != SEGMENT_VERSION ||
+         segment->size != sizeof( SysInfoSnapshot ) )
+        return false;
+
+    // the writer holds the sequence odd only for a memcpy, retrying a few
+    // times is enough unless it died in between
+    for ( int attempt = 0; attempt < 100; ++attempt )
+    {
+        const quint32 sequence = segment->sequence;
+        if ( sequence & 1 )
+        {
+            sched_yield();
+            continue;
+        }
+        __sync_synchronize();
+        snapshot = segment->snapshot;
+        results = segment->results;
+        const quint32 dataSize = qMin( segment->dataSize, quint32( DATA_SIZE ) );
+        data.resize( dataSize );
+        memcpy( data.data(), segment->data, dataSize );
+        const qint64 published = segment->published;
+        const qint64 interval = segment->interval;
+        __sync_synchronize();
+        if ( segment->sequence != sequence )
+            continue;
+
+        const qint64 now = monotonicMs();
+        if ( !published || now - published > STALE_INTERVALS * interval )
+            return false;
+        segment->lastRead = now;
+        return true;
+    }
+    return false;
+}
+
+qint64 SharedSnapshot::idleTime() const
+{
+    return m_segment ? monotonicMs() - m_segment->lastRead : 0;
+}
@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////
+// sharedsnapshot.h                                                     //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _sharedsnapshot_H_
+#define _sharedsnapshot_H_
+
+#include "snapshot.h"
+
+#include <qbytearray.h>
+
+/**
+ * The latest snapshot of the sampler daemon, shared with the slaves.
+ *
+ * A POSIX shared memory segment per user holds one SysInfoSnapshot, which
+ * is a flat block and can be copied in and out as is, followed by the
+ * streamed SamplerData. Both are guarded by a sequence lock: the single
+ * writer makes the sequence odd, copies them in and makes it even again;
+ * readers copy them out and retry if the sequence was odd or changed
+ * meanwhile. Neither side ever blocks the other, and any number of slaves
+ * can read.
+ */
+class SharedSnapshot
+{
+public:
+    SharedSnapshot();
+    ~SharedSnapshot();
+
+    /**
+     * Open the segment as its writer, creating it if needed. There can only
+     * be one writer, the segment is locked as long as it stays open.
+     * @param interval sampling interval in ms, readers consider a snapshot
+     * stale after missing a few of them
+     * @return false if another writer has it or it can't be created
+     */
+    bool openWriter( int interval );
+
+    /**
+     * Map the segment for reading
+     * @return false if there is no sampler
+     */
+    bool openReader();
+
+    bool isOpen() const { return m_segment != 0; }
+    void close();
+
+    /**
+     * Publish @p snapshot, the bitmask of the collectors which succeeded and
+     * the streamed SamplerData, which is left out if it's too large
+     */
+    void publish( const SysInfoSnapshot & snapshot, int results, const QByteArray & data );
+
+    /**
+     * Copy the latest snapshot into @p snapshot, the collector results into
+     * @p results and the SamplerData into @p data
+     * @return false if the writer stopped publishing or never did
+     */
+    bool read( SysInfoSnapshot & snapshot, int & results, QByteArray & data );
+
+    /**
+     * @return ms since a reader last got a snapshot, or since the writer
+     * opened the segment
+     */
+    qint64 idleTime() const;
+
+private:
+    Q_DISABLE_COPY( SharedSnapshot )
+
+    struct Segment;
+
+    Segment * m_segment;
+    int m_fd;
+};
+
+#endif
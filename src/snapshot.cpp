@@ -0,0 +1,135 @@
+//////////////////////////////////////////////////////////////////////////
+// snapshot.cpp                                                         //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "snapshot.h"
+
+#include <QString>
+
+#include <string.h>
+
+#include <kdebug.h>
+
+static const char * const numberNames[] = {
+    "mem_totalram", "mem_freeram", "mem_available", "mem_cached", "mem_shmem", "mem_sunreclaim",
+    "mem_hugepages_total", "mem_hugepages_free", "mem_totalswap", "mem_freeswap", "mem_zswap",
+    "mem_zswapped", "mem_zram_used", "mem_zram_data", "system_uptime", "cpu_speed", "cpu_cores",
+    "cpu_temp", "gfx_accelerated", "batt_is_plugged", "batt_charge_perc", "batt_charge_state",
+    "batt_is_rechargeable", "ac_is_plugged", "net_status"
+};
+
+static const char * const textNames[] = {
+    "os_sysname", "os_release", "os_version", "os_machine", "os_hostname", "os_system", "cpu_model",
+    "gfx_vendor", "gfx_model", "gfx_2d_driver", "gfx_3d_driver", "gfx_mesa_version", "qt5_version",
+    "kf5_version", "kdeapps_version", "plasma_version", "wayland_ver"
+};
+
+// fails to compile when a field is added without its name, or the other way round
+typedef char numberNamesComplete[sizeof( numberNames ) / sizeof( *numberNames ) == SysInfoSnapshot::NUMBER_COUNT ? 1 : -1];
+typedef char textNamesComplete[sizeof( textNames ) / sizeof( *textNames ) == SysInfoSnapshot::TEXT_COUNT ? 1 : -1];
+
+void SysInfoSnapshot::clear()
+{
+    memset( numbers, 0, sizeof( numbers ) );
+    numbersPresent = 0;
+    memset( textOffset, 0, sizeof( textOffset ) );
+    memset( textLength, 0xff, sizeof( textLength ) );
+    arenaUsed = 0;
+}
+
+void SysInfoSnapshot::setNumber( Number field, qint64 value )
+{
+    numbers[field] = value;
+    numbersPresent |= Q_UINT64_C( 1 ) << field;
+}
+
+QByteArray SysInfoSnapshot::utf8( Text field ) const
+{
+    if ( !has( field ) )
+        return QByteArray();
+    return QByteArray( arena + textOffset[field], textLength[field] );
+}
+
+QString SysInfoSnapshot::text( Text field ) const
+{
+    if ( !has( field ) )
+        return QString();
+    return QString::fromUtf8( arena + textOffset[field], textLength[field] );
+}
+
+void SysInfoSnapshot::setText( Text field, const char * value, int length )
+{
+    const int room = int( ARENA_SIZE ) - arenaUsed;
+    if ( length > room )
+    {
+        // cut at the start of the UTF-8 sequence the end falls into
+        int cut = room;
+        while ( cut > 0 && ( value[cut] & 0xc0 ) == 0x80 )
+            --cut;
+        kDebug(1242) << "No room for" << name( field ) << "in the snapshot, keeping" << cut << "of" << length << "bytes";
+        if ( !cut )
+        {
+            textLength[field] = NO_TEXT;
+            return;
+        }
+        length = cut;
+    }
+    memcpy( arena + arenaUsed, value, length );
+    textOffset[field] = arenaUsed;
+    textLength[field] = length;
+    arenaUsed += length;
+}
+
+void SysInfoSnapshot::setText( Text field, const QByteArray & value )
+{
+    setText( field, value.constData(), value.size() );
+}
+
+void SysInfoSnapshot::setText( Text field, const QString & value )
+{
+    if ( value.isNull() )
+        textLength[field] = NO_TEXT;
+    else
+        setText( field, value.toUtf8() );
+}
+
+const char * SysInfoSnapshot::name( Number field )
+{
+    return numberNames[field];
+}
+
+const char * SysInfoSnapshot::name( Text field )
+{
+    return textNames[field];
+}
+
+void SysInfoSnapshot::merge( const SysInfoSnapshot & other )
+{
+    for ( int i = 0; i < NUMBER_COUNT; ++i )
+    {
+        if ( other.has( Number( i ) ) )
+            setNumber( Number( i ), other.numbers[i] );
+    }
+    for ( int i = 0; i < TEXT_COUNT; ++i )
+    {
+        if ( other.has( Text( i ) ) )
+            setText( Text( i ), other.arena + other.textOffset[i], other.textLength[i] );
+    }
+}
@@ -0,0 +1,144 @@
+//////////////////////////////////////////////////////////////////////////
+// snapshot.h                                                           //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _snapshot_H_
+#define _snapshot_H_
+
+#include <qbytearray.h>
+#include <qglobal.h>
+
+class QString;
+
+/**
+ * Typed snapshot of everything the collectors gather
+ *
+ * Numbers live in fixed slots, strings are stored UTF-8 encoded in a fixed
+ * arena inside the struct, so a snapshot is a single flat block without
+ * pointers: copying it is a memcpy, lookups are array accesses and filling
+ * it doesn't touch the heap. Values are raw, formatting and localization
+ * are left to the renderers (HTML page, JSON document).
+ */
+struct SysInfoSnapshot
+{
+    /**
+     * Numeric fields. Snapshot logs store them by position, new ones go
+     * right before NUMBER_COUNT.
+     */
+    enum Number
+    {
+        MEM_TOTALRAM = 0,       // in bytes
+        MEM_FREERAM,            // in bytes
+        MEM_AVAILABLE,          // MemAvailable, what can be allocated without swapping, in bytes
+        MEM_CACHED,             // reclaimable caches: page cache without shmem, reclaimable slab, in bytes
+        MEM_SHMEM,              // shared memory and tmpfs, in bytes
+        MEM_SUNRECLAIM,         // unreclaimable slab, in bytes
+        MEM_HUGEPAGES_TOTAL,    // huge page pool, in bytes
+        MEM_HUGEPAGES_FREE,     // in bytes
+        MEM_TOTALSWAP,          // in bytes
+        MEM_FREESWAP,           // in bytes
+        MEM_ZSWAP,              // zswap pool size, in bytes
+        MEM_ZSWAPPED,           // uncompressed size of the pages in it, in bytes
+        MEM_ZRAM_USED,          // memory used by zram devices, in bytes
+        MEM_ZRAM_DATA,          // uncompressed size of the data they hold, in bytes
+        SYSTEM_UPTIME,          // in seconds
+        CPU_SPEED,              // in kHz
+        CPU_CORES,              // number of CPUs
+        CPU_TEMP,               // in degrees Celsius
+        GFX_ACCELERATED,        // 0 for software rendering
+        BATT_IS_PLUGGED,        // see Solid::Battery
+        BATT_CHARGE_PERC,
+        BATT_CHARGE_STATE,      // Solid::Battery::ChargeState
+        BATT_IS_RECHARGEABLE,
+        AC_IS_PLUGGED,          // see Solid::AcAdapter
+        NET_STATUS,             // Solid::Networking::Status
+        NUMBER_COUNT
+    };
+
+    /**
+     * String fields, same as above
+     */
+    enum Text
+    {
+        OS_SYSNAME = 0,         // man 2 uname
+        OS_RELEASE,
+        OS_VERSION,
+        OS_MACHINE,
+        OS_HOSTNAME,
+        OS_SYSTEM,              // OS version
+        CPU_MODEL,
+        GFX_VENDOR,             // Display stuff
+        GFX_MODEL,
+        GFX_2D_DRIVER,
+        GFX_3D_DRIVER,
+        GFX_MESA_VERSION,
+        QT5_VERSION,
+        KF5_VERSION,
+        KDEAPPS_VERSION,
+        PLASMA_VERSION,
+        WAYLAND_VER,
+        TEXT_COUNT
+    };
+
+    enum { ARENA_SIZE = 4096 };
+
+    /**
+     * Reset to an empty snapshot
+     */
+    void clear();
+
+    bool has( Number field ) const { return numbersPresent & ( Q_UINT64_C( 1 ) << field ); }
+    qint64 number( Number field ) const { return numbers[field]; }
+    void setNumber( Number field, qint64 value );
+
+    bool has( Text field ) const { return textLength[field] != NO_TEXT; }
+    QByteArray utf8( Text field ) const;
+    QString text( Text field ) const;
+
+    /**
+     * Store @p length bytes of UTF-8 at @p value. If the arena is full it's
+     * cut short at a character boundary, or left absent if nothing fits.
+     */
+    void setText( Text field, const char * value, int length );
+    void setText( Text field, const QByteArray & value );
+    void setText( Text field, const QString & value );
+
+    /**
+     * @return the name of @p field as used in JSON output, e.g. "mem_totalram"
+     */
+    static const char * name( Number field );
+    static const char * name( Text field );
+
+    /**
+     * Copy every field present in @p other, overriding ours
+     */
+    void merge( const SysInfoSnapshot & other );
+
+    enum { NO_TEXT = 0xffff };
+
+    qint64 numbers[NUMBER_COUNT];
+    quint64 numbersPresent;
+    quint16 textOffset[TEXT_COUNT];
+    quint16 textLength[TEXT_COUNT];     // NO_TEXT if absent
+    quint16 arenaUsed;
+    char arena[ARENA_SIZE];
+};
+
+#endif
@@ -0,0 +1,372 @@
+//////////////////////////////////////////////////////////////////////////
+// snapshotlog.cpp                                                      //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "snapshotlog.h"
+
+#include <kdebug.h>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stddef.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LOG_MAGIC 0x6b736c67        // "kslg"
+#define LOG_VERSION 1
+#define LOG_BYTE_ORDER 0x01020304
+#define RECORD_MAGIC 0x6b737263     // "ksrc"
+
+// in textLength of a record, the string is absent
+#define NO_TEXT_LENGTH 0xffffffff
+
+// a record older than the last one by at most this many ms was taken by
+// another writer meanwhile and is dropped, more means the clock was set
+// back and the log is rolled so that timestamps keep growing along it
+#define CLOCK_SKEW_MS 60000
+
+struct FileHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 byteOrder;              // LOG_BYTE_ORDER as written by the host
+    quint32 reserved;
+    qint64 lastTimestamp;           // of the last record appended
+};
+
+/*
+ * Followed by qint64 numbers[numberCount], quint32 textOffset[textCount],
+ * quint32 textLength[textCount] and the string table of stringsSize bytes,
+ * padded to a multiple of 8
+ */
+struct SnapshotLogRecord
+{
+    quint32 magic;
+    quint32 check;                  // FNV-1a of the record, but this field
+    quint32 size;                   // of the whole record
+    quint16 numberCount;
+    quint16 textCount;
+    qint64 timestamp;               // ms since the epoch
+    quint64 numbersPresent;
+    qint32 results;                 // collectors which succeeded
+    quint32 stringsSize;
+};
+
+static quint32 align8( quint32 size )
+{
+    return ( size + 7 ) & ~7u;
+}
+
+static quint32 fnv1a( quint32 hash, const char * data, quint32 length )
+{
+    for ( quint32 i = 0; i < length; ++i )
+        hash = ( hash ^ quint8( data[i] ) ) * 16777619u;
+    return hash;
+}
+
+static quint32 checksum( const char * record, quint32 size )
+{
+    const quint32 hash = fnv1a( 2166136261u, record, offsetof( SnapshotLogRecord, check ) );
+    const quint32 skip = offsetof( SnapshotLogRecord, check ) + sizeof( quint32 );
+    return fnv1a( hash, record + skip, size - skip );
+}
+
+static bool validHeader( const FileHeader & header )
+{
+    return header.magic == LOG_MAGIC && header.version == LOG_VERSION && header.byteOrder == LOG_BYTE_ORDER;
+}
+
+SnapshotLog::SnapshotLog( const QByteArray & path, qint64 maxSize )
+    : m_path( path ), m_maxSize( maxSize )
+{
+}
+
+qint64 SnapshotLog::now()
+{
+    struct timespec ts;
+    clock_gettime( CLOCK_REALTIME, &ts );
+    return qint64( ts.tv_sec ) * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * Open the log and lock it, making sure it wasn't rolled by another writer
+ * while we waited for the lock
+ */
+int SnapshotLog::openLocked()
+{
+    for ( int attempt = 0; attempt < 3; ++attempt )
+    {
+        const int fd = open( m_path.constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0600 );
+        if ( fd < 0 )
+        {
+            kDebug(1242) << "Can't open" << m_path << ":" << strerror( errno );
+            return -1;
+        }
+        struct stat opened, current;
+        if ( flock( fd, LOCK_EX ) == 0 && fstat( fd, &opened ) == 0 &&
+             stat( m_path.constData(), &current ) == 0 &&
+             opened.st_dev == current.st_dev && opened.st_ino == current.st_ino )
+            return fd;
+        close( fd );
+    }
+    return -1;
+}
+
+bool SnapshotLog::append( const SysInfoSnapshot & snapshot, int results, qint64 timestamp )
+{
+    // build the record
+    const quint32 numbersSize = SysInfoSnapshot::NUMBER_COUNT * sizeof( qint64 );
+    const quint32 textsSize = SysInfoSnapshot::TEXT_COUNT * sizeof( quint32 );
+    const quint32 size = align8( sizeof( SnapshotLogRecord ) + numbersSize + 2 * textsSize + snapshot.arenaUsed );
+    QByteArray buffer( size, '\0' );
+    char * record = buffer.data();
+
+    SnapshotLogRecord * header = reinterpret_cast<SnapshotLogRecord *>( record );
+    header->magic = RECORD_MAGIC;
+    header->size = size;
+    header->numberCount = SysInfoSnapshot::NUMBER_COUNT;
+    header->textCount = SysInfoSnapshot::TEXT_COUNT;
+    header->timestamp = timestamp;
+    header->numbersPresent = snapshot.numbersPresent;
+    header->results = results;
+    header->stringsSize = snapshot.arenaUsed;
+
+    char * p = record + sizeof( SnapshotLogRecord );
+    memcpy( p, snapshot.numbers, numbersSize );
+    p += numbersSize;
+    quint32 * textOffset = reinterpret_cast<quint32 *>( p );
+    quint32 * textLength = textOffset + SysInfoSnapshot::TEXT_COUNT;
+    for ( int i = 0; i < SysInfoSnapshot::TEXT_COUNT; ++i )
+    {
+        const bool has = snapshot.textLength[i] != SysInfoSnapshot::NO_TEXT;
+        textOffset[i] = has ? snapshot.textOffset[i] : 0;
+        textLength[i] = has ? snapshot.textLength[i] : NO_TEXT_LENGTH;
+    }
+    memcpy( p + 2 * textsSize, snapshot.arena, snapshot.arenaUsed );
+    header->check = checksum( record, size );
+
+    // at most one roll: a fresh log always takes the record
+    for ( int pass = 0; pass < 2; ++pass )
+    {
+        const int fd = openLocked();
+        if ( fd < 0 )
+            return false;
+
+        struct stat st;
+        FileHeader fileHeader;
+        bool fresh = false;
+        bool roll = false;
+        if ( fstat( fd, &st ) < 0 )
+        {
+            close( fd );
+            return false;
+        }
+        if ( st.st_size == 0 )
+            fresh = true;
+        else if ( pread( fd, &fileHeader, sizeof( fileHeader ), 0 ) != sizeof( fileHeader ) || !validHeader( fileHeader ) )
+            roll = true;    // not ours, or of another version: moved away, never truncated
+        else if ( timestamp < fileHeader.lastTimestamp )
+        {
+            if ( fileHeader.lastTimestamp - timestamp <= CLOCK_SKEW_MS )
+            {
+                close( fd );
+                return false;
+            }
+            roll = true;
+        }
+        else if ( align8( st.st_size ) + size > m_maxSize && align8( st.st_size ) > sizeof( FileHeader ) )
+            roll = true;
+
+        if ( roll && pass == 0 )
+        {
+            // whoever waits for the lock of the old log notices the rename
+            const QByteArray previous = m_path + ".1";
+            const bool renamed = rename( m_path.constData(), previous.constData() ) == 0;
+            close( fd );
+            if ( !renamed )
+            {
+                kDebug(1242) << "Can't roll" << m_path << ":" << strerror( errno );
+                return false;
+            }
+            continue;
+        }
+
+        if ( fresh )
+        {
+            memset( &fileHeader, 0, sizeof( fileHeader ) );
+            fileHeader.magic = LOG_MAGIC;
+            fileHeader.version = LOG_VERSION;
+            fileHeader.byteOrder = LOG_BYTE_ORDER;
+        }
+
+        // a torn record at the end is left in place, readers skip it
+        const off_t offset = fresh ? off_t( sizeof( FileHeader ) ) : off_t( align8( st.st_size ) );
+        fileHeader.lastTimestamp = timestamp;
+        const bool ok = !roll &&
+                        pwrite( fd, record, size, offset ) == ssize_t( size ) &&
+                        pwrite( fd, &fileHeader, sizeof( fileHeader ), 0 ) == sizeof( fileHeader );
+        if ( !ok && !roll )
+            kDebug(1242) << "Can't write to" << m_path << ":" << strerror( errno );
+        close( fd );
+        return ok;
+    }
+    return false;
+}
+
+SnapshotLogReader::SnapshotLogReader()
+    : m_data( 0 ), m_size( 0 )
+{
+}
+
+SnapshotLogReader::~SnapshotLogReader()
+{
+    close();
+}
+
+void SnapshotLogReader::close()
+{
+    if ( m_data )
+        munmap( const_cast<char *>( m_data ), m_size );
+    m_data = 0;
+    m_size = 0;
+}
+
+bool SnapshotLogReader::open( const QByteArray & path )
+{
+    close();
+
+    const int fd = ::open( path.constData(), O_RDONLY | O_CLOEXEC );
+    if ( fd < 0 )
+        return false;
+
+    // only what's there now is mapped, the log never shrinks so this stays
+    // valid while writers append
+    struct stat st;
+    void * map = MAP_FAILED;
+    if ( fstat( fd, &st ) == 0 && st.st_size >= off_t( sizeof( FileHeader ) ) )
+        map = mmap( 0, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    ::close( fd );
+    if ( map == MAP_FAILED )
+        return false;
+
+    m_data = static_cast<const char *>( map );
+    m_size = st.st_size;
+    if ( !validHeader( *reinterpret_cast<const FileHeader *>( m_data ) ) )
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @return the record at @p offset, 0 if there is no complete one. This
+ * hashes the whole record, so each one is validated only once, by scan().
+ */
+const SnapshotLogRecord * SnapshotLogReader::validRecord( qint64 offset ) const
+{
+    if ( offset + qint64( sizeof( SnapshotLogRecord ) ) > m_size )
+        return 0;
+    const SnapshotLogRecord * header = reinterpret_cast<const SnapshotLogRecord *>( m_data + offset );
+    if ( header->magic != RECORD_MAGIC || header->size % 8 || offset + header->size > m_size )
+        return 0;
+    const quint64 contents = sizeof( SnapshotLogRecord ) + quint64( header->numberCount ) * sizeof( qint64 ) +
+                             quint64( header->textCount ) * 2 * sizeof( quint32 ) + header->stringsSize;
+    if ( contents > header->size || checksum( m_data + offset, header->size ) != header->check )
+        return 0;
+    return header;
+}
+
+/**
+ * Find the first valid record starting in [@p from, @p to)
+ * @param offset set to its offset, -1 if there is none
+ * @return its header, 0 if there is none
+ */
+const SnapshotLogRecord * SnapshotLogReader::scan( qint64 from, qint64 to, qint64 & offset ) const
+{
+    for ( offset = from; offset < to; offset += 8 )
+        if ( const SnapshotLogRecord * record = validRecord( offset ) )
+            return record;
+    offset = -1;
+    return 0;
+}
+
+qint64 SnapshotLogReader::first() const
+{
+    qint64 offset;
+    scan( sizeof( FileHeader ), m_size, offset );
+    return offset;
+}
+
+qint64 SnapshotLogReader::next( qint64 offset ) const
+{
+    qint64 following;
+    scan( offset + header( offset )->size, m_size, following );
+    return following;
+}
+
+qint64 SnapshotLogReader::find( qint64 timestamp ) const
+{
+    // the records in [lo, hi) are yet to be looked at
+    qint64 found = -1;
+    qint64 lo = sizeof( FileHeader );
+    qint64 hi = m_size;
+    while ( lo < hi )
+    {
+        const qint64 mid = lo + ( ( ( hi - lo ) / 2 ) & ~qint64( 7 ) );
+        qint64 offset;
+        const SnapshotLogRecord * record = scan( mid, hi, offset );
+        if ( record && record->timestamp <= timestamp )
+        {
+            found = offset;
+            lo = offset + record->size;
+        }
+        else
+            hi = mid;
+    }
+    return found;
+}
+
+void SnapshotLogReader::read( qint64 offset, SysInfoSnapshot & snapshot, int & results, qint64 & timestamp ) const
+{
+    const SnapshotLogRecord * record = header( offset );
+    snapshot.clear();
+    results = record->results;
+    timestamp = record->timestamp;
+
+    // only the fields both versions know
+    const char * p = m_data + offset + sizeof( SnapshotLogRecord );
+    const int numberCount = qMin( int( record->numberCount ), int( SysInfoSnapshot::NUMBER_COUNT ) );
+    memcpy( snapshot.numbers, p, numberCount * sizeof( qint64 ) );
+    snapshot.numbersPresent = record->numbersPresent &
+                              ( numberCount < 64 ? ( Q_UINT64_C( 1 ) << numberCount ) - 1 : ~Q_UINT64_C( 0 ) );
+
+    const quint32 * textOffset = reinterpret_cast<const quint32 *>( p + record->numberCount * sizeof( qint64 ) );
+    const quint32 * textLength = textOffset + record->textCount;
+    const char * strings = reinterpret_cast<const char *>( textLength + record->textCount );
+    const int textCount = qMin( int( record->textCount ), int( SysInfoSnapshot::TEXT_COUNT ) );
+    for ( int i = 0; i < textCount; ++i )
+        if ( textLength[i] != NO_TEXT_LENGTH && quint64( textOffset[i] ) + textLength[i] <= record->stringsSize )
+            snapshot.setText( SysInfoSnapshot::Text( i ), strings + textOffset[i], textLength[i] );
+}
@@ -0,0 +1,136 @@
+//////////////////////////////////////////////////////////////////////////
+// snapshotlog.h                                                        //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _snapshotlog_H_
+#define _snapshotlog_H_
+
+#include "snapshot.h"
+
+struct SnapshotLogRecord;
+
+/**
+ * Rolling on-disk log of snapshots.
+ *
+ * Records are appended in a compact binary form: a fixed header with the
+ * timestamp and the field counts, the numeric columns, the offset and
+ * length of each string in a string table, then the string table itself,
+ * i.e. the used part of the snapshot arena. Everything is 8 byte aligned
+ * and in host byte order, so a reader can use a mapped log in place, and
+ * each record carries a checksum, so a torn one at the end of the log is
+ * skipped. Field numbering is that of SysInfoSnapshot, readers of other
+ * versions use the fields both sides know.
+ *
+ * Once the log would exceed its maximum size it's moved to <path>.1,
+ * replacing the previous one, and a new log is started.
+ */
+class SnapshotLog
+{
+public:
+    /**
+     * @param path of the log, in local 8 bit encoding
+     * @param maxSize in bytes
+     */
+    SnapshotLog( const QByteArray & path, qint64 maxSize );
+
+    /**
+     * Append @p snapshot, the bitmask of the collectors which succeeded
+     * and its @p timestamp, in ms since the epoch. Several processes can
+     * append to the same log, the file is locked meanwhile.
+     * @return false if it can't be written, or is dropped because the log
+     * has a newer one already
+     */
+    bool append( const SysInfoSnapshot & snapshot, int results, qint64 timestamp );
+
+    /**
+     * @return the current time in ms since the epoch
+     */
+    static qint64 now();
+
+    const QByteArray & path() const { return m_path; }
+
+private:
+    int openLocked();
+
+    QByteArray m_path;
+    qint64 m_maxSize;
+};
+
+/**
+ * Read only view of a snapshot log, mapped into memory.
+ *
+ * Records are found by binary search over the file offsets: from any
+ * offset the reader skips ahead to the next valid record header, and
+ * timestamps grow along the log.
+ */
+class SnapshotLogReader
+{
+public:
+    SnapshotLogReader();
+    ~SnapshotLogReader();
+
+    /**
+     * Map the log at @p path
+     * @return false if it doesn't exist or isn't a snapshot log
+     */
+    bool open( const QByteArray & path );
+    void close();
+    bool isOpen() const { return m_data != 0; }
+
+    /**
+     * @return offset of the last record taken at or before @p timestamp,
+     * -1 if there is none
+     */
+    qint64 find( qint64 timestamp ) const;
+
+    /**
+     * @return offset of the first record, -1 if the log is empty
+     */
+    qint64 first() const;
+
+    /**
+     * @return offset of the record following the one at @p offset, -1 at
+     * the end of the log
+     */
+    qint64 next( qint64 offset ) const;
+
+    /**
+     * Decode the record at @p offset, as returned by the functions above.
+     * These validated the record already, it isn't checked again.
+     */
+    void read( qint64 offset, SysInfoSnapshot & snapshot, int & results, qint64 & timestamp ) const;
+
+private:
+    Q_DISABLE_COPY( SnapshotLogReader )
+
+    const SnapshotLogRecord * validRecord( qint64 offset ) const;
+    const SnapshotLogRecord * scan( qint64 from, qint64 to, qint64 & offset ) const;
+
+    /**
+     * @return the header of the record at @p offset, which was validated
+     */
+    const SnapshotLogRecord * header( qint64 offset ) const
+    { return reinterpret_cast<const SnapshotLogRecord *>( m_data + offset ); }
+
+    const char * m_data;
+    qint64 m_size;
+};
+
+#endif
@@ -22,54 +22,56 @@
 //////////////////////////////////////////////////////////////////////////
 
 #include "sysinfo.h"
-
-#include <config-kiosysinfo.h>
-
-#ifdef HAVE_HD
-#include <hd.h>
-#endif
+#include "cpuinfo.h"
+#include "cpufreq.h"
+#include "cputopology.h"
+#include "meminfo.h"
+#include "numainfo.h"
+#include "jsonwriter.h"
+#include "sensors.h"
+#include "pressure.h"
+#include "diskspace.h"
+#include "devicecache.h"
+#include "history.h"
+#include "snapshotlog.h"
 
 #include <QApplication>
 #include <QFile>
+#include <QHash>
 #include <QDir>
 #include <QTextStream>
-#include <QtGui/QX11Info>
-#include <QDesktopWidget>
+#include <QMutex>
+#include <QRunnable>
+#include <QSharedPointer>
+#include <QThreadPool>
+#include <QTime>
+#include <QVector>
+#include <QWaitCondition>
 
 #include <stdlib.h>
 #include <math.h>
 #include <unistd.h>
-#include <sys/sysinfo.h>
 #include <sys/stat.h>
+#include <sys/sysmacros.h>
 #include <sys/types.h>
 #include <stdio.h>
 #include <mntent.h>
-#include <sys/vfs.h>
 #include <string.h>
-#include <sys/utsname.h>
 
 #include <kdebug.h>
 #include <kglobal.h>
 #include <kstandarddirs.h>
 #include <klocale.h>
 #include <kiconloader.h>
-#include <kdeversion.h>
 #include <kuser.h>
 #include <kglobalsettings.h>
-#include <kmountpoint.h>
 #include <kcomponentdata.h>
-#include <KDesktopFile>
 #include <KConfigGroup>
 
 #include <solid/networking.h>
 #include <solid/device.h>
-#include <solid/storagedrive.h>
-#include <solid/storageaccess.h>
-#include <solid/storagevolume.h>
-#include <solid/block.h>
 #include <solid/battery.h>
 #include <solid/acadapter.h>
-#include <solid/opticaldisc.h>
 
 #define SOLID_MEDIALIST_PREDICATE \
     "[[ StorageVolume.usage == 'FileSystem' OR StorageVolume.usage == 'Encrypted' ]" \
@@ -81,6 +83,9 @@
 
 #define BR "<br>"
 
+// how long get() waits for the collectors before rendering without them
+#define COLLECTOR_DEADLINE_MS 10000
+
 static QString formattedUnit( quint64 value, int post=1 )
 {
     if (value >= (1024 * 1024))
@@ -99,193 +104,963 @@ static QString htmlQuote(const QString& _s)
     return s.replace("&", "&amp;").replace("<", "&lt;").replace(">", "&gt;");
 }
 
-static QString readFromFile( const QString & filename, const QString & info = QString(),
-                             const char * sep = 0, bool returnlast = false )
+static QString netStatus( int status )
+{
+    switch (status)
+    {
+    case Solid::Networking::Disconnecting:
+        return i18n( "Network is <strong>shutting down</strong>" );
+    case Solid::Networking::Connecting:
+        return i18n( "<strong>Establishing</strong> connection to the network" );
+    case Solid::Networking::Connected:
+        return i18n( "You are <strong>online</strong>" );
+    case Solid::Networking::Unconnected:
+        return i18n( "You are <strong>offline</strong>" );
+    case Solid::Networking::Unknown:
+    default:
+        return QString();
+    }
+}
+
+/**
+ * @return the full path of data file @p name, looked up once per process
+ */
+static QString locateData( const QString & name )
+{
+    static QHash<QString, QString> located;
+    QHash<QString, QString>::ConstIterator it = located.constFind( name );
+    if ( it == located.constEnd() )
+        it = located.insert( name, KStandardDirs::locate( "data", name ) );
+    return it.value();
+}
+
+/**
+ * my-computer.html, split at its %N placeholders once per process.
+ *
+ * segments[i] is followed by placeholder slots[i] (0 after the last one),
+ * rendering just appends the UTF-8 segments and slot values in turn.
+ */
+struct PageTemplate
+{
+    QList<QByteArray> segments;
+    QList<int> slots;
+
+    void parse( const QString & text )
+    {
+        QRegExp placeholder( "%(\\d)" );
+        int pos = 0, match;
+        while ( ( match = placeholder.indexIn( text, pos ) ) >= 0 )
+        {
+            segments << text.mid( pos, match - pos ).toUtf8();
+            slots << placeholder.cap( 1 ).toInt();
+            pos = match + placeholder.matchedLength();
+        }
+        segments << text.mid( pos ).toUtf8();
+        slots << 0;
+    }
+
+    /**
+     * Append the segments starting at @p pos to @p out, filling slot n
+     * with @p values[n - 1], until slot @p stop is reached
+     * @return the position to continue from
+     */
+    int render( QByteArray & out, int pos, const QByteArray * values, int count, int stop ) const
+    {
+        for ( ; pos < segments.size(); ++pos )
+        {
+            out += segments.at( pos );
+            const int slot = slots.at( pos );
+            if ( slot == stop )
+                return pos + 1;
+            if ( slot > 0 && slot <= count )
+                out += values[slot - 1];
+        }
+        return pos;
+    }
+};
+
+// the page body goes into this slot, the ones before it never change
+#define PAGE_BODY_SLOT 6
+
+static const PageTemplate & pageTemplate()
+{
+    static PageTemplate page;
+    if ( page.segments.isEmpty() )
+    {
+        QFile f( locateData( "sysinfo/about/my-computer.html" ) );
+        f.open( QIODevice::ReadOnly );
+        QTextStream t( &f );
+        page.parse( t.readAll() );
+    }
+    return page;
+}
+
+/**
+ * The page up to the body, rendered once per process
+ */
+static const QByteArray & pageHead( int & tailPos )
+{
+    static QByteArray head;
+    static int tail = 0;
+    if ( head.isEmpty() )
+    {
+        const QByteArray values[] = {
+            i18n( "My Computer" ).toUtf8(),
+            htmlQuote( "file:" + locateData( "sysinfo/about/shared.css" ) ).toUtf8(),
+            htmlQuote( "file:" + locateData( "sysinfo/about/style.css" ) ).toUtf8(),
+            i18n( "My Computer" ).toUtf8(),
+            i18n( "Folders, Harddisks, Removable Devices, System Information and more..." ).toUtf8()
+        };
+        tail = pageTemplate().render( head, 0, values, 5, PAGE_BODY_SLOT );
+    }
+    tailPos = tail;
+    return head;
+}
+
+/**
+ * One run of a collector on the pool.
+ *
+ * Shared between get() and the pool thread: a run which misses the deadline
+ * keeps a reference and finishes writing into it, the next get() finds it
+ * still in flight and waits for it again instead of starting another one,
+ * so a hung collector ties up a single pool thread at most.
+ */
+struct CollectorRun
 {
-    kDebug() << "Reading " << info << " from " << filename;
+    CollectorRun()
+        : result( false ), done( false )
+    {
+        info.clear();
+    }
 
-    QFile file( filename );
+    QMutex lock;
+    QWaitCondition finished;
+    SysInfoSnapshot info;
+    bool result;
+    bool done;
+};
+
+/**
+ * The collector runs get() waits for: the current one of each collector,
+ * and the last one which completed before it, used if the current one
+ * misses the deadline
+ */
+struct CollectorBatch
+{
+    explicit CollectorBatch( int count )
+        : runs( count ), previous( count ) {}
 
-    if ( !file.exists() || !file.open( QIODevice::ReadOnly ) )
-        return QString::null;
+    QVector<CollectorRunPtr> runs;
+    QVector<CollectorRunPtr> previous;
+};
 
-    QTextStream stream( &file );
-    QString line, result;
+class CollectorTask : public QRunnable
+{
+public:
+    CollectorTask( bool (*collector)( SysInfoSnapshot & ), const CollectorRunPtr & run )
+        : m_collector( collector ), m_run( run ) {}
 
-    do
+    void run()
     {
-        line = stream.readLine();
-        if ( !line.isEmpty() )
+        SysInfoSnapshot info;
+        info.clear();
+        const bool result = m_collector( info );
+
+        QMutexLocker locker( &m_run->lock );
+        m_run->info = info;
+        m_run->result = result;
+        m_run->done = true;
+        m_run->finished.wakeAll();
+    }
+
+private:
+    bool (*m_collector)( SysInfoSnapshot & );
+    CollectorRunPtr m_run;
+};
+
+static bool isDone( const CollectorRunPtr & run )
+{
+    QMutexLocker locker( &run->lock );
+    return run->done;
+}
+
+/**
+ * Wait until collector @p slot of @p batch is done or @p deadline ms passed
+ * since @p started. If it finished in time, the fields it filled are merged
+ * into @p info, else those of its previous run, if any.
+ * @return the collector's result, false if it missed the deadline without
+ * a previous run
+ */
+static bool waitForCollector( const CollectorBatchPtr & batch, int slot, const QTime & started,
+                              int deadline, SysInfoSnapshot & info )
+{
+    CollectorRun * run = batch->runs[slot].data();
+    QMutexLocker locker( &run->lock );
+    while ( !run->done )
+    {
+        const int remaining = deadline - started.elapsed();
+        if ( remaining <= 0 || !run->finished.wait( &run->lock, remaining ) )
         {
-            if ( !sep )
-                result = line;
-            else if ( line.startsWith( info ) )
-                result = line.section( sep, 1, 1 );
+            if ( run->done )
+                break;
+            kDebug(1242) << "Collector" << slot << "missed the deadline of" << deadline << "ms";
+            locker.unlock();
 
-            if (!result.isEmpty() && !returnlast)
-                return result;
+            // done for good, nobody writes to it anymore
+            if ( const CollectorRunPtr previous = batch->previous[slot] )
+            {
+                info.merge( previous->info );
+                return previous->result;
+            }
+            return false;
         }
-    } while (!line.isNull());
+    }
 
-    return result;
+    info.merge( run->info );
+    return run->result;
+}
+
+/**
+ * Result of collector @p slot, from the sampler's @p sampled bitmask if
+ * there is no @p batch, else waited for as above
+ */
+static bool collected( const CollectorBatchPtr & batch, int sampled, int slot, const QTime & started,
+                       SysInfoSnapshot & info )
+{
+    if ( !batch )
+        return sampled & ( 1 << slot );
+    return waitForCollector( batch, slot, started, COLLECTOR_DEADLINE_MS, info );
 }
 
-static QString netStatus()
+CollectorBatchPtr kio_sysinfoProtocol::startCollectors( int which )
 {
-    switch (Solid::Networking::status())
+    if ( !which )
+        return CollectorBatchPtr();
+    CollectorBatchPtr batch( new CollectorBatch( COLL_COUNT ) );
+    for ( int i = 0; i < COLL_COUNT; ++i )
     {
-    case Solid::Networking::Disconnecting:
-        return i18n( "Network is <strong>shutting down</strong>" );
-    case Solid::Networking::Connecting:
-        return i18n( "<strong>Establishing</strong> connection to the network" );
-    case Solid::Networking::Connected:
-        return i18n( "You are <strong>online</strong>" );
-    case Solid::Networking::Unconnected:
-        return i18n( "You are <strong>offline</strong>" );
-    case Solid::Networking::Unknown:
-    default:
-        return QString();
+        if ( !( which & ( 1 << i ) ) )
+            continue;
+
+        // a run still in flight is waited for again, not started anew
+        CollectorRunPtr & run = m_runs[i];
+        if ( !run || isDone( run ) )
+        {
+            if ( run )
+                m_completedRuns[i] = run;
+            run = CollectorRunPtr( new CollectorRun );
+            m_pool->start( new CollectorTask( collector( i ), run ) );
+        }
+        batch->runs[i] = run;
+        batch->previous[i] = m_completedRuns[i];
     }
+    return batch;
+}
+
+int kio_sysinfoProtocol::readSampler()
+{
+    int results;
+    if ( ( m_sampler.isOpen() || m_sampler.openReader() ) && m_sampler.read( m_snapshot, results, m_samplerBuffer ) )
+    {
+        m_haveSamplerData = m_samplerData.load( m_samplerBuffer );
+        // the sampler is back and keeps the history again
+        if ( m_haveSamplerData && m_history && !m_history->isStopping() )
+            m_history->stop();
+        return results;
+    }
+    // try again next time, the sampler may have been restarted meanwhile
+    m_sampler.close();
+    m_snapshot.clear();
+    m_haveSamplerData = false;
+
+    // the slave keeps the history until the sampler is back, one stopped
+    // meanwhile starts over, its series have a gap anyway
+    if ( m_history && m_history->isStopping() )
+    {
+        delete m_history;
+        m_history = 0;
+    }
+    if ( !m_history )
+        m_history = createHistory();
+    return -1;
+}
+
+const CpuStat & kio_sysinfoProtocol::cpuStat() const
+{
+    return m_haveSamplerData ? m_samplerData.cpuStat : m_cpuStat;
+}
+
+const CpuFreq * kio_sysinfoProtocol::cpuFreq()
+{
+    if ( m_haveSamplerData )
+        return m_samplerData.freq.policies().isEmpty() ? 0 : &m_samplerData.freq;
+    return m_freq.read() ? &m_freq : 0;
+}
+
+QVector<SensorReading> kio_sysinfoProtocol::sensorReadings()
+{
+    return m_haveSamplerData ? m_samplerData.sensors : Sensors::system().read();
+}
+
+bool kio_sysinfoProtocol::pressureStats( int resource, PressureStats & stats )
+{
+    if ( !m_haveSamplerData )
+        return Pressure::read( Pressure::Resource( resource ), stats );
+    stats = m_samplerData.pressure[resource];
+    return m_samplerData.havePressure[resource];
+}
+
+int kio_sysinfoProtocol::historyMinutes() const
+{
+    if ( m_haveSamplerData )
+        return m_samplerData.historyMinutes;
+    return m_history ? m_history->minutes() : 0;
+}
+
+QVector<qint64> kio_sysinfoProtocol::historyPoints( int metric ) const
+{
+    QVector<qint64> values;
+    if ( m_haveSamplerData )
+        values = m_samplerData.history[metric];
+    else if ( m_history )
+        m_history->series( History::Metric( metric ) ).points( values );
+    return values;
+}
+
+QVector<qint64> kio_sysinfoProtocol::diskHistory( const QString & mountPoint ) const
+{
+    QVector<qint64> values;
+    if ( m_haveSamplerData )
+        values = m_samplerData.diskHistory.value( mountPoint );
+    else if ( const TimeSeries * series = m_history ? m_history->disk( mountPoint ) : 0 )
+        series->points( values );
+    return values;
 }
 
 kio_sysinfoProtocol::kio_sysinfoProtocol( const QByteArray & pool_socket, const QByteArray & app_socket )
-    : SlaveBase( "kio_sysinfo", pool_socket, app_socket )
+    : SlaveBase( "kio_sysinfo", pool_socket, app_socket ), m_deviceCache( 0 ), m_haveSamplerData( false ),
+      m_history( 0 ), m_logInterval( 0 ), m_lastLogged( 0 )
 {
     m_predicate = Solid::Predicate::fromString(SOLID_MEDIALIST_PREDICATE);
+
+    // not the global pool, a hung collector must not starve anyone else
+    m_pool = new QThreadPool;
+    m_pool->setMaxThreadCount( 8 );
+    m_runs.resize( COLL_COUNT );
+    m_completedRuns.resize( COLL_COUNT );
+
+    const KConfigGroup cg( KGlobal::config(), "Pressure" );
+    if ( cg.readEntry( "Triggers", false ) )
+        m_pressure.arm( cg.readEntry( "TriggerStall", PRESSURE_STALL_MS ),
+                        cg.readEntry( "TriggerWindow", PRESSURE_WINDOW_MS ) );
+
+    m_log = createLog( m_logInterval );
 }
 
 kio_sysinfoProtocol::~kio_sysinfoProtocol()
 {
+    // m_pool is leaked on purpose: ~QThreadPool() waits for running tasks and
+    // a hung collector must not keep the slave from exiting
+    delete m_deviceCache;
+    delete m_history;
+    delete m_log;
 }
 
-void kio_sysinfoProtocol::get( const KUrl & /*url*/ )
+/**
+ * Wrap section @p name for the page, sysinfo:/section/<name> serves the
+ * contents of the div on its own
+ */
+static QString sectionDiv( const char * name, const QString & html )
 {
+    return QString( "<div id=\"section-%1\">" ).arg( name ) + html + "</div>";
+}
+
+void kio_sysinfoProtocol::get( const KUrl & url )
+{
+    if ( url.queryItem( "format" ) == "json" )
+    {
+        if ( url.hasQueryItem( "at" ) )
+            loggedGet( url );
+        else if ( url.hasQueryItem( "from" ) )
+            loggedRangeGet( url );
+        else
+            jsonGet();
+        return;
+    }
+    if ( url.path().startsWith( "/section/" ) )
+    {
+        sectionGet( url );
+        return;
+    }
+
  //   mimeType( "application/x-sysinfo" );
     mimeType( "text/html" );
 
-    // CPU info
-    infoMessage( i18n( "Looking for CPU information..." ) );
-    cpuInfo();
-
-    // header
-    QString location = KStandardDirs::locate( "data", "sysinfo/about/my-computer.html" );
-    QFile f( location );
-    f.open( QIODevice::ReadOnly );
-    QTextStream t( &f );
-    QString content = t.readAll();
-    content = content.arg( i18n( "My Computer" ),
-                           htmlQuote("file:" + KStandardDirs::locate( "data", "sysinfo/about/shared.css" )),
-                           htmlQuote("file:" + KStandardDirs::locate( "data", "sysinfo/about/style.css" )),
-                           i18n( "My Computer"),
-                           i18n( "Folders, Harddisks, Removable Devices, System Information and more..." ));
-
-    QString sysInfo = "<div id=\"column2\">"; // table with 2 cols
-    QString dummy;
-
-    osInfo();
+    // the collected fields come from the sampler daemon if there is one,
+    // else everything not talking to Solid runs on the pool, meanwhile we
+    // query Solid here as it isn't usable from other threads
+    infoMessage( i18n( "Looking for system information..." ) );
+    QTime started;
+    started.start();
+    m_snapshot.clear();
+    const int sampled = readSampler();
+    const CollectorBatchPtr batch = startCollectors( sampled < 0 ? ( 1 << COLL_COUNT ) - 1 : 0 );
+    if ( !m_haveSamplerData )
+        m_cpuStat.sample();
+
+    // header, sent right away so the part can start laying out the page
+    int tailPos;
+    data( pageHead( tailPos ) );
+
+    // battery info
+    infoMessage( i18n( "Looking for battery and AC information..." ) );
+    const bool haveBattery = batteryInfo();
+
+    // the sections follow in page order, each one is sent as soon as the
+    // collectors it needs are done
+    const bool haveOs = collected( batch, sampled, COLL_OS, started, m_snapshot );
+    const bool haveKde = collected( batch, sampled, COLL_KDE, started, m_snapshot );
+    data( ( "<div id=\"column2\">" + sectionDiv( "os", osSection( haveOs, haveKde ) ) ).toUtf8() ); // table with 2 cols
+
+    const bool haveGl = collected( batch, sampled, COLL_GL, started, m_snapshot );
+    const bool haveWayland = collected( batch, sampled, COLL_WAYLAND, started, m_snapshot );
+    data( sectionDiv( "display", displaySection( haveGl ) ).toUtf8() );
+
+    // sent empty if there is no battery, so the part has something to patch
+    data( sectionDiv( "battery", haveBattery ? batterySection() : QString() ).toUtf8() );
+
+    const bool haveCpu = collected( batch, sampled, COLL_CPU, started, m_snapshot );
+    data( sectionDiv( "cpu", haveCpu ? cpuSection() : QString() ).toUtf8() );
+
+    const bool haveMemory = collected( batch, sampled, COLL_MEMORY, started, m_snapshot );
+    data( ( sectionDiv( "memory", memorySection() ) + sectionDiv( "pressure", pressureSection() ) + "</div>" ).toUtf8() );
+
+    // second column
+    infoMessage( i18n( "Looking up network status..." ) );
+    m_snapshot.setNumber( SysInfoSnapshot::NET_STATUS, Solid::Networking::status() );
+    data( ( "</div><div id=\"column1\">" + sectionDiv( "net", netSection() ) ).toUtf8() );
+
+    // disk info
+    infoMessage( i18n( "Looking for disk information..." ) );
+    data( sectionDiv( "disks", disksSection() ).toUtf8() );
+
+    // Send the rest of the page
+    QByteArray tail;
+    pageTemplate().render( tail, tailPos, 0, 0, -1 );
+    data( tail );
+    data( QByteArray() ); // empty array means we're done sending the data
+    finished();
+
+    // the sampler daemon logs its own snapshots
+    const qint64 now = SnapshotLog::now();
+    if ( m_log && sampled < 0 && qAbs( now - m_lastLogged ) >= m_logInterval )
+    {
+        const int results = ( haveCpu << COLL_CPU ) | ( haveOs << COLL_OS ) | ( haveKde << COLL_KDE ) |
+                            ( haveGl << COLL_GL ) | ( haveWayland << COLL_WAYLAND ) | ( haveMemory << COLL_MEMORY );
+        m_log->append( m_snapshot, results, now );
+        m_lastLogged = now;
+    }
+}
+
+void kio_sysinfoProtocol::sectionGet( const KUrl & url )
+{
+    const QString name = url.path().mid( 9 );
+
+    // the collectors of the section, if any
+    int ids[2] = { -1, -1 };
+    if ( name == "os" )
+    {
+        ids[0] = COLL_OS;
+        ids[1] = COLL_KDE;
+    }
+    else if ( name == "display" )
+    {
+        ids[0] = COLL_GL;
+        ids[1] = COLL_WAYLAND;
+    }
+    else if ( name == "cpu" )
+        ids[0] = COLL_CPU;
+    else if ( name == "memory" )
+        ids[0] = COLL_MEMORY;
+    else if ( name != "battery" && name != "pressure" && name != "net" && name != "disks" )
+    {
+        error( KIO::ERR_DOES_NOT_EXIST, url.prettyUrl() );
+        return;
+    }
+
+    mimeType( "text/html" );
+    m_snapshot.clear();
+
+    // same deadline as for the page
+    QTime started;
+    started.start();
+    const int sampled = readSampler();
+    int which = 0;
+    for ( int i = 0; i < 2; ++i )
+        if ( ids[i] >= 0 )
+            which |= 1 << ids[i];
+    const CollectorBatchPtr batch = startCollectors( sampled < 0 ? which : 0 );
+    bool result[2] = { false, false };
+    for ( int i = 0; i < 2; ++i )
+        if ( ids[i] >= 0 )
+            result[i] = collected( batch, sampled, ids[i], started, m_snapshot );
+
+    QString html;
+    if ( name == "os" )
+        html = osSection( result[0], result[1] );
+    else if ( name == "display" )
+        html = displaySection( result[0] );
+    else if ( name == "battery" )
+        html = batteryInfo() ? batterySection() : QString();
+    else if ( name == "cpu" )
+    {
+        if ( !m_haveSamplerData )
+            m_cpuStat.sample();
+        html = result[0] ? cpuSection() : QString();
+    }
+    else if ( name == "memory" )
+        html = memorySection();
+    else if ( name == "pressure" )
+        html = pressureSection();
+    else if ( name == "net" )
+    {
+        m_snapshot.setNumber( SysInfoSnapshot::NET_STATUS, Solid::Networking::status() );
+        html = netSection();
+    }
+    else
+        html = disksSection();
+
+    data( html.toUtf8() );
+    data( QByteArray() ); // empty array means we're done sending the data
+    finished();
+}
+
+QString kio_sysinfoProtocol::disksSection()
+{
+    m_devices.clear();
+    return "<h2 id=\"hdds\">" + i18n( "Disk Information" ) + "</h2>" + diskInfo();
+}
+
+QString kio_sysinfoProtocol::osSection( bool os, bool kde )
+{
+    const SysInfoSnapshot & info = m_snapshot;
+    QString sysInfo;
+
     sysInfo += "<h2 id=\"sysinfo\">" +i18n( "OS Information" ) + "</h2>";
     sysInfo += "<table>";
-    sysInfo += "<tr><td>" + i18n( "OS:" ) +  "</td><td>" + htmlQuote(m_info[OS_SYSTEM]) + "</td></tr>";
-    sysInfo += "<tr><td>" + i18n( "Kernel:" ) + "</td><td>" + htmlQuote(m_info[OS_SYSNAME]) + " " +
-               htmlQuote(m_info[OS_RELEASE]) + " " + htmlQuote(m_info[OS_MACHINE]) + "</td></tr>";
-
-    if ( kdeInfo() )
-    {
-        if (!m_info[QT5_VERSION].isNull())
-            sysInfo += "<tr><td>" + i18n( "Qt:" ) + "</td><td>" + htmlQuote(m_info[QT5_VERSION]) + "</td></tr>";
-        
-	//TODO: Don't hardcode the filename here
-	const QString filePath("/usr/share/xsessions/plasma.desktop");
-	KDesktopFile desktopFile(filePath);
-	QString plasmaVersion = desktopFile.desktopGroup().readEntry("X-KDE-PluginInfo-Version", KDE::versionString());
-	sysInfo += "<tr><td>" + i18n( "Plasma:" ) + "</td><td>" + plasmaVersion + "</td></tr>";
-	
-	if (!m_info[KF5_VERSION].isNull())
-            sysInfo += "<tr><td>" + i18n( "KDE Frameworks:" ) + "</td><td>" + htmlQuote(m_info[KF5_VERSION]) + "</td></tr>";
-        if (!m_info[KDEAPPS_VERSION].isNull())
-            sysInfo += "<tr><td>" + i18n( "KDE Applications:" ) + "</td><td>" + htmlQuote(m_info[KDEAPPS_VERSION]) + "</td></tr>";
-    }
-    
-//     sysInfo += "<tr><td>" + i18n( "Current user:" ) + "</td><td>" + htmlQuote(m_info[OS_USER]) + "@"
-//                + htmlQuote(m_info[OS_HOSTNAME]) + "</td></tr>"
+    if ( os )
+    {
+        const QString system = info.has( SysInfoSnapshot::OS_SYSTEM ) ? info.text( SysInfoSnapshot::OS_SYSTEM )
+                               : i18nc( "Unknown operating system version", "Unknown" );
+        sysInfo += "<tr><td>" + i18n( "OS:" ) +  "</td><td>" + htmlQuote(system) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Kernel:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::OS_SYSNAME )) + " " +
+                   htmlQuote(info.text( SysInfoSnapshot::OS_RELEASE )) + " " + htmlQuote(info.text( SysInfoSnapshot::OS_MACHINE )) + "</td></tr>";
+    }
+
+    if ( kde )
+    {
+        if (info.has( SysInfoSnapshot::QT5_VERSION ))
+            sysInfo += "<tr><td>" + i18n( "Qt:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::QT5_VERSION )) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Plasma:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::PLASMA_VERSION )) + "</td></tr>";
+        if (info.has( SysInfoSnapshot::KF5_VERSION ))
+            sysInfo += "<tr><td>" + i18n( "KDE Frameworks:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::KF5_VERSION )) + "</td></tr>";
+        if (info.has( SysInfoSnapshot::KDEAPPS_VERSION ))
+            sysInfo += "<tr><td>" + i18n( "KDE Applications:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::KDEAPPS_VERSION )) + "</td></tr>";
+    }
+
+//     sysInfo += "<tr><td>" + i18n( "Current user:" ) + "</td><td>" + htmlQuote(KUser().loginName()) + "@"
+//                + htmlQuote(info.text( SysInfoSnapshot::OS_HOSTNAME )) + "</td></tr>"
     sysInfo += "</table>";
-    
-    // Display Info START ////////
+
+    return sysInfo;
+}
+
+QString kio_sysinfoProtocol::displaySection( bool gl )
+{
+    const SysInfoSnapshot & info = m_snapshot;
+    QString sysInfo;
 
     // OpenGL info
-    if ( glInfo() )
+    if ( gl )
     {
         sysInfo += "<h2 id=\"display\">" + i18n( "Display Info" ) + "</h2>";
         sysInfo += "<table>";
-        sysInfo += "<tr><td>" + i18n( "Vendor:" ) + "</td><td>" + htmlQuote(m_info[GFX_MODEL]) +  "</td></tr>";
-//         sysInfo += "<tr><td>" + i18n( "Model:" ) + "</td><td>" + htmlQuote(m_info[GFX_MODEL]) + "</td></tr>";
-        sysInfo += "<tr><td>" + i18n( "2D driver:" ) + "</td><td>" + htmlQuote(m_info[GFX_2D_DRIVER]) + "</td></tr>";
-        if (!m_info[GFX_3D_DRIVER].isNull())
-            sysInfo += "<tr><td>" + i18n( "3D driver:" ) + "</td><td>" + htmlQuote(m_info[GFX_3D_DRIVER]) + "</td></tr>";
-    }
-    waylandInfo();
-    if (!m_info[WAYLAND_VER].isNull())
-            sysInfo += "<tr><td>" + i18n( "Wayland:" ) + "</td><td>" + htmlQuote(m_info[WAYLAND_VER]) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Vendor:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::GFX_MODEL )) +  "</td></tr>";
+//         sysInfo += "<tr><td>" + i18n( "Model:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::GFX_MODEL )) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "2D driver:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::GFX_2D_DRIVER )) + "</td></tr>";
+        if (info.has( SysInfoSnapshot::GFX_3D_DRIVER ))
+        {
+            QString driver = info.text( SysInfoSnapshot::GFX_3D_DRIVER );
+            if (info.has( SysInfoSnapshot::GFX_ACCELERATED ) && !info.number( SysInfoSnapshot::GFX_ACCELERATED ))
+                driver = QString("%1 (%2)").arg(driver).arg(i18n("No 3D Acceleration"));
+            if (info.has( SysInfoSnapshot::GFX_MESA_VERSION ))
+                driver += QString(" (%1)").arg(info.text( SysInfoSnapshot::GFX_MESA_VERSION ));
+            sysInfo += "<tr><td>" + i18n( "3D driver:" ) + "</td><td>" + htmlQuote(driver) + "</td></tr>";
+        }
+    }
+    if (info.has( SysInfoSnapshot::WAYLAND_VER ))
+            sysInfo += "<tr><td>" + i18n( "Wayland:" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::WAYLAND_VER )) + "</td></tr>";
     sysInfo += "</table>";
-    
-    // Display Info END /////////
 
-    // battery info
-    infoMessage( i18n( "Looking for battery and AC information..." ) );
-    if ( batteryInfo() )
+    return sysInfo;
+}
+
+/**
+ * Inline SVG plot of the TimeSeries points @p values scaled to [0, @p high],
+ * a gap where points are missing
+ */
+static QString sparkline( const QVector<qint64> & values, qint64 high, const QString & title )
+{
+    if ( values.size() < 2 || high <= 0 )
+        return QString();
+
+    QString lines, points;
+    int count = 0;
+    for ( int i = 0; i <= values.size(); ++i )
     {
-        sysInfo += "<h2 id=\"battery\">" + i18n( "Battery Information" ) + "</h2>";
-        sysInfo += "<table>";
-        if (!m_info[BATT_IS_PLUGGED].isEmpty())
-            sysInfo += "<tr><td>" + i18n( "Battery present:" ) + "</td><td>" + m_info[BATT_IS_PLUGGED] + "</td></tr>";
-        if (!m_info[BATT_CHARGE_STATE].isEmpty())
-            sysInfo += "<tr><td>" + i18nc( "battery state", "State:" ) + "</td><td>" + m_info[BATT_CHARGE_STATE] + "</td></tr>";
-        if (!m_info[BATT_CHARGE_PERC].isEmpty())
-            sysInfo += "<tr><td>" + i18n( "Charge percent:" ) + "</td><td>" + m_info[BATT_CHARGE_PERC] + "</td></tr>";
-        if (!m_info[BATT_IS_RECHARGEABLE].isEmpty())
-            sysInfo += "<tr><td>" + i18n( "Rechargeable:" ) + "</td><td>" + m_info[BATT_IS_RECHARGEABLE] + "</td></tr>";
-        if (!m_info[AC_IS_PLUGGED].isEmpty())
-            sysInfo += "<tr><td>" + i18n( "AC plugged:" ) + "</td><td>" + m_info[AC_IS_PLUGGED] + "</td></tr>";
-        sysInfo += "</table>";
+        if ( i == values.size() || values.at( i ) == TimeSeries::NO_VALUE )
+        {
+            if ( count > 1 )
+                lines += "<polyline points=\"" + points + "\"/>";
+            points.clear();
+            count = 0;
+            continue;
+        }
+        const int y = 100 - qBound( 0, int( values.at( i ) * 100 / high ), 100 );
+        points += QString( "%1,%2 " ).arg( i ).arg( y );
+        ++count;
     }
+    if ( lines.isEmpty() )
+        return QString();
+
+    return QString( "<svg class=\"sparkline\" xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"0 0 %1 100\" "
+                    "preserveAspectRatio=\"none\"><title>%2</title>%3</svg>" )
+           .arg( values.size() - 1 ).arg( htmlQuote( title ) ).arg( lines );
+}
 
-    // more CPU info
-    if ( !m_info[CPU_MODEL].isNull() )
+static QString yesNo( qint64 value )
+{
+    return value ? i18n( "yes" ) : i18n( "no" );
+}
+
+static QString chargeState( int state )
+{
+    switch ( state )
     {
-        sysInfo += "<h2 id=\"cpu\">" + i18n( "CPU Information" ) + "</h2>";
-        sysInfo += "<table>";
-        sysInfo += "<tr><td>" + i18n( "Processor (CPU):" ) + "</td><td>" + htmlQuote(m_info[CPU_MODEL]) + "</td></tr>";
-        sysInfo += "<tr><td>" + i18n( "Speed:" ) + "</td><td>" +
-                   i18n( "%1 MHz" , KGlobal::locale()->formatNumber( m_info[CPU_SPEED].toFloat(), 2 ) ) + "</td></tr>";
-        int core_num = m_info[CPU_CORES].toUInt() + 1;
-        if ( core_num > 1 )
-            sysInfo += "<tr><td>" + i18n("Cores:") + QString("</td><td>%1</td></tr>").arg(core_num);
+    case Solid::Battery::NoCharge:
+        return i18nc( "battery charge state", "No Charge" );
+    case Solid::Battery::Charging:
+        return i18nc( "battery charge state", "Charging" );
+    case Solid::Battery::Discharging:
+        return i18nc( "battery charge state", "Discharging" );
+    default:
+        return i18nc( "battery charge state", "Unknown" );
+    }
+}
+
+QString kio_sysinfoProtocol::batterySection()
+{
+    const SysInfoSnapshot & info = m_snapshot;
+    QString sysInfo;
+
+    sysInfo += "<h2 id=\"battery\">" + i18n( "Battery Information" ) + "</h2>";
+    sysInfo += "<table>";
+    if (info.has( SysInfoSnapshot::BATT_IS_PLUGGED ))
+        sysInfo += "<tr><td>" + i18n( "Battery present:" ) + "</td><td>" + yesNo( info.number( SysInfoSnapshot::BATT_IS_PLUGGED ) ) + "</td></tr>";
+    if (info.has( SysInfoSnapshot::BATT_CHARGE_STATE ))
+        sysInfo += "<tr><td>" + i18nc( "battery state", "State:" ) + "</td><td>" + chargeState( info.number( SysInfoSnapshot::BATT_CHARGE_STATE ) ) + "</td></tr>";
+    if (info.has( SysInfoSnapshot::BATT_CHARGE_PERC ))
+        sysInfo += "<tr><td>" + i18n( "Charge percent:" ) + "</td><td>" +
+                   i18nc( "battery charge percent label", "%1%", info.number( SysInfoSnapshot::BATT_CHARGE_PERC ) ) +
+                   sparkline( historyPoints( History::BatteryCharge ), 100,
+                              i18np( "Charge over the last minute", "Charge over the last %1 minutes", historyMinutes() ) ) + "</td></tr>";
+    if (info.has( SysInfoSnapshot::BATT_IS_RECHARGEABLE ))
+        sysInfo += "<tr><td>" + i18n( "Rechargeable:" ) + "</td><td>" + yesNo( info.number( SysInfoSnapshot::BATT_IS_RECHARGEABLE ) ) + "</td></tr>";
+    if (info.has( SysInfoSnapshot::AC_IS_PLUGGED ))
+        sysInfo += "<tr><td>" + i18n( "AC plugged:" ) + "</td><td>" + yesNo( info.number( SysInfoSnapshot::AC_IS_PLUGGED ) ) + "</td></tr>";
+    sysInfo += "</table>";
+
+    return sysInfo;
+}
 
-        if (!m_info[CPU_TEMP].isEmpty())
+static QString mhz( quint32 kHz )
+{
+    return i18n( "%1 MHz", KGlobal::locale()->formatNumber( kHz / 1000.0, 0 ) );
+}
+
+/**
+ * Frequency scaling rows of the CPU table: the current frequency averaged
+ * per socket, so a throttled one stands out, and the distinct ranges and
+ * governors with the number of CPUs using each
+ */
+static QString frequencyRows( const CpuFreq & freq, const CpuTopology & topology )
+{
+    QString rows;
+
+    if ( topology.packageCount() > 1 )
+    {
+        QMap<int, QPair<quint64, int> > sockets;
+        Q_FOREACH ( const CpuPlacement & cpu, topology.cpus() )
         {
-            sysInfo += "<tr><td>" + i18n("Temperature:") + QString("</td><td>%1</td></tr>").arg(m_info[CPU_TEMP]);
+            if ( const CpuFreqPolicy * policy = freq.policyOf( cpu.cpu ) )
+            {
+                QPair<quint64, int> & socket = sockets[cpu.package];
+                socket.first += policy->curKHz;
+                ++socket.second;
+            }
         }
-        sysInfo += "</table>";
+        QStringList lines;
+        for ( QMap<int, QPair<quint64, int> >::ConstIterator it = sockets.constBegin(); it != sockets.constEnd(); ++it )
+            lines << i18nc( "socket number: average frequency", "Socket %1: %2", it.key(), mhz( it.value().first / it.value().second ) );
+        rows += "<tr><td>" + i18n("Speed per socket:") + "</td><td>" + lines.join( BR ) + "</td></tr>";
+    }
+
+    QMap<QString, int> scaling;
+    Q_FOREACH ( const CpuFreqPolicy & policy, freq.policies() )
+    {
+        QString text = i18nc( "frequency range, governor", "%1 – %2, %3", mhz( policy.minKHz ), mhz( policy.maxKHz ),
+                              QString::fromLatin1( policy.governor ) );
+        if ( !policy.preference.isEmpty() )
+            text += " (" + QString::fromLatin1( policy.preference ) + ")";
+        scaling[text] += policy.cpus.size();
+    }
+    QStringList lines;
+    for ( QMap<QString, int>::ConstIterator it = scaling.constBegin(); it != scaling.constEnd(); ++it )
+    {
+        if ( scaling.size() > 1 )
+            lines << i18np( "%2: 1 CPU", "%2: %1 CPUs", it.value(), htmlQuote( it.key() ) );
+        else
+            lines << htmlQuote( it.key() );
     }
+    rows += "<tr><td>" + i18n("Scaling:") + "</td><td>" + lines.join( BR ) + "</td></tr>";
+
+    return rows;
+}
+
+QString kio_sysinfoProtocol::cpuSection()
+{
+    const SysInfoSnapshot & info = m_snapshot;
+    QString sysInfo;
+
+    sysInfo += "<h2 id=\"cpu\">" + i18n( "CPU Information" ) + "</h2>";
+    sysInfo += "<table>";
+    sysInfo += "<tr><td>" + i18n( "Processor (CPU):" ) + "</td><td>" + htmlQuote(info.text( SysInfoSnapshot::CPU_MODEL )) + "</td></tr>";
+    sysInfo += "<tr><td>" + i18n( "Speed:" ) + "</td><td>" +
+               i18n( "%1 MHz" , KGlobal::locale()->formatNumber( info.number( SysInfoSnapshot::CPU_SPEED ) / 1000.0, 2 ) ) + "</td></tr>";
+    const qint64 core_num = info.number( SysInfoSnapshot::CPU_CORES );
+    if ( core_num > 1 )
+        sysInfo += "<tr><td>" + i18n("Cores:") + QString("</td><td>%1</td></tr>").arg(core_num);
+
+    const CpuTopology & topology = CpuTopology::system();
+    if ( const CpuFreq * freq = cpuFreq() )
+        sysInfo += frequencyRows( *freq, topology );
+
+    if ( topology.cpuCount() )
+    {
+        QStringList parts;
+        parts << i18np( "1 socket", "%1 sockets", topology.packageCount() )
+              << i18np( "1 NUMA node", "%1 NUMA nodes", topology.nodeCount() )
+              << i18np( "1 core", "%1 cores", topology.coreCount() )
+              << i18np( "1 thread per core", "%1 threads per core", topology.threadsPerCore() );
+        sysInfo += "<tr><td>" + i18n("Topology:") + "</td><td>" + parts.join( ", " ) + "</td></tr>";
+
+        QStringList caches;
+        Q_FOREACH ( const CpuCacheInfo & cache, topology.caches() )
+        {
+            QString text = i18nc( "CPU cache: name, size, count", "%1: %2 × %3",
+                                  QString( "L%1%2" ).arg( cache.level ).arg( cache.type == 'u' ? QString() : QString( QLatin1Char( cache.type ) ) ),
+                                  formattedUnit( cache.size, 0 ), cache.instances );
+            if ( cache.sharedBy > 1 )
+                text += " " + i18np( "(shared by 1 CPU)", "(shared by %1 CPUs)", cache.sharedBy );
+            caches << text;
+        }
+        if ( !caches.isEmpty() )
+            sysInfo += "<tr><td>" + i18n("Caches:") + "</td><td>" + caches.join( BR ) + "</td></tr>";
+    }
+
+    // per package and per core temperatures where the driver has them
+    QStringList temps, fans;
+    Q_FOREACH ( const SensorReading & reading, sensorReadings() )
+    {
+        if ( reading.kind == SensorReading::Fan )
+            fans << i18nc( "fan name: speed", "%1: %2 RPM", QString::fromUtf8( reading.label ), reading.value );
+        else if ( Sensors::isCpu( reading ) )
+            temps << i18nc( "sensor name: temperature", "%1: %2 °C", QString::fromUtf8( reading.label ),
+                            qRound64( reading.value / 1000.0 ) );
+    }
+    if (temps.size() > 1)
+        sysInfo += "<tr><td>" + i18n("Temperature:") + "</td><td>" + htmlQuote( temps.join( "\n" ) ).replace( "\n", BR ) + "</td></tr>";
+    else if (info.has( SysInfoSnapshot::CPU_TEMP ))
+    {
+        sysInfo += "<tr><td>" + i18n("Temperature:") + "</td><td>" +
+                   i18nc("temperature", "%1 °C", info.number( SysInfoSnapshot::CPU_TEMP )) + "</td></tr>";
+    }
+    if (!fans.isEmpty())
+        sysInfo += "<tr><td>" + i18n("Fans:") + "</td><td>" + htmlQuote( fans.join( "\n" ) ).replace( "\n", BR ) + "</td></tr>";
+
+    // one cell per CPU, colored by how busy it was since the previous request,
+    // or over the sampler's last interval
+    const CpuStat & stat = cpuStat();
+    if ( stat.intervalCount() )
+    {
+        sysInfo += "<tr><td>" + i18n("Load:") + "</td><td><div class=\"heatmap\">";
+        for ( int cpu = 0; cpu < stat.cpuCount(); ++cpu )
+        {
+            if ( !stat.online( cpu ) )
+            {
+                sysInfo += QString( "<span class=\"offline\" title=\"%1\"></span>" ).arg( i18n( "CPU %1: offline", cpu ) );
+                continue;
+            }
+            QColor c;
+            c.setHsv( 100 - qRound( stat.busy( cpu ) ), 180, 230 );
+            const QString title = i18nc( "per-CPU load", "CPU %1: %2% user, %3% system, %4% I/O wait, %5% steal", cpu,
+                                         qRound( stat.percent( cpu, CpuStat::User ) ),
+                                         qRound( stat.percent( cpu, CpuStat::System ) ),
+                                         qRound( stat.percent( cpu, CpuStat::IoWait ) ),
+                                         qRound( stat.percent( cpu, CpuStat::Steal ) ) );
+            sysInfo += QString( "<span style=\"background-color: %1\" title=\"%2\"></span>" ).arg( c.name() ).arg( title );
+        }
+        sysInfo += "</div></td></tr>";
+    }
+    sysInfo += "</table>";
+
+    return sysInfo;
+}
+
+QString kio_sysinfoProtocol::memorySection()
+{
+    const SysInfoSnapshot & info = m_snapshot;
+    QString sysInfo;
 
-    // memory info
-    infoMessage( i18n( "Looking for memory information..." ) );
-    memoryInfo();
     sysInfo += "<h2 id=\"memory\">" + i18n( "Memory Information" ) + "</h2>";
     sysInfo += "<table>";
-    sysInfo += "<tr><td>" + i18n( "Total memory (RAM):" ) + "</td><td>" + m_info[MEM_TOTALRAM] + "</td></tr>";
-    sysInfo += "<tr><td>" + i18n( "Free memory:" ) + "</td><td>" + m_info[MEM_FREERAM] + "</td></tr>";
-    dummy = i18n( "Used Memory" );
-    dummy += "<tr><td>" + i18n( "Total swap:" ) + "</td><td>" + m_info[MEM_TOTALSWAP] + "</td></tr>";
-    sysInfo += "<tr><td>" + i18n( "Free swap:" ) + "</td><td>" + m_info[MEM_FREESWAP] + "</td></tr>";
+    if (info.has( SysInfoSnapshot::MEM_TOTALRAM ))
+    {
+        const quint64 total = info.number( SysInfoSnapshot::MEM_TOTALRAM );
+        const quint64 available = info.number( SysInfoSnapshot::MEM_AVAILABLE );
+        sysInfo += "<tr><td>" + i18n( "Total memory (RAM):" ) + "</td><td>" + formattedUnit( total ) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Available memory:" ) + "</td><td>" +
+                   i18nc( "available memory, percentage of total", "%1 (%2%)", formattedUnit( available ),
+                          total ? qRound( available * 100.0 / total ) : 0 ) +
+                   sparkline( historyPoints( History::MemoryUsed ), total,
+                              i18np( "Memory used over the last minute", "Memory used over the last %1 minutes", historyMinutes() ) ) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Free memory:" ) + "</td><td>" + formattedUnit( info.number( SysInfoSnapshot::MEM_FREERAM ) ) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Caches:" ) + "</td><td>" + formattedUnit( info.number( SysInfoSnapshot::MEM_CACHED ) ) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Shared memory:" ) + "</td><td>" + formattedUnit( info.number( SysInfoSnapshot::MEM_SHMEM ) ) + "</td></tr>";
+        sysInfo += "<tr><td>" + i18n( "Unreclaimable slab:" ) + "</td><td>" + formattedUnit( info.number( SysInfoSnapshot::MEM_SUNRECLAIM ) ) + "</td></tr>";
+        if (info.has( SysInfoSnapshot::MEM_HUGEPAGES_TOTAL ))
+        {
+            sysInfo += "<tr><td>" + i18n( "Huge pages:" ) + "</td><td>" +
+                       i18nc( "huge pages: free, total", "%1 free of %2",
+                              formattedUnit( info.number( SysInfoSnapshot::MEM_HUGEPAGES_FREE ) ),
+                              formattedUnit( info.number( SysInfoSnapshot::MEM_HUGEPAGES_TOTAL ) ) ) + "</td></tr>";
+        }
+        sysInfo += "<tr><td>" + i18n( "Free swap:" ) + "</td><td>" +
+                   i18nc( "swap: free, total", "%1 of %2", formattedUnit( info.number( SysInfoSnapshot::MEM_FREESWAP ) ),
+                          formattedUnit( info.number( SysInfoSnapshot::MEM_TOTALSWAP ) ) ) +
+                   sparkline( historyPoints( History::SwapUsed ), info.number( SysInfoSnapshot::MEM_TOTALSWAP ),
+                              i18np( "Swap used over the last minute", "Swap used over the last %1 minutes", historyMinutes() ) ) + "</td></tr>";
+        if (info.has( SysInfoSnapshot::MEM_ZSWAP ))
+        {
+            sysInfo += "<tr><td>" + i18n( "Zswap:" ) + "</td><td>" +
+                       i18nc( "compressed swap: stored, memory used", "%1 in %2",
+                              formattedUnit( info.number( SysInfoSnapshot::MEM_ZSWAPPED ) ),
+                              formattedUnit( info.number( SysInfoSnapshot::MEM_ZSWAP ) ) ) + "</td></tr>";
+        }
+        if (info.has( SysInfoSnapshot::MEM_ZRAM_USED ))
+        {
+            sysInfo += "<tr><td>" + i18n( "Zram:" ) + "</td><td>" +
+                       i18nc( "compressed swap: stored, memory used", "%1 in %2",
+                              formattedUnit( info.number( SysInfoSnapshot::MEM_ZRAM_DATA ) ),
+                              formattedUnit( info.number( SysInfoSnapshot::MEM_ZRAM_USED ) ) ) + "</td></tr>";
+        }
+    }
     sysInfo += "</table>";
 
-    sysInfo += "</div>";
+    // per node breakdown, imbalance between nodes shows up as latency
+    if ( NumaInfo::read( m_numaNodes ) && m_numaNodes.size() > 1 )
+    {
+        KLocale * locale = KGlobal::locale();
+        sysInfo += "<table class=\"numa\">";
+        sysInfo += "<tr><th>" + i18n( "Node" ) + "</th><th>" + i18n( "Total" ) + "</th><th>" + i18n( "Free" ) +
+                   "</th><th>" + i18n( "Page cache" ) + "</th><th>" + i18n( "Anonymous" ) +
+                   "</th><th>" + i18n( "Hits" ) + "</th><th>" + i18n( "Misses" ) + "</th><th>" + i18n( "Foreign" ) + "</th></tr>";
+        Q_FOREACH ( const NumaNodeInfo & node, m_numaNodes )
+        {
+            sysInfo += QString( "<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td><td>%5</td><td>%6</td><td>%7</td><td>%8</td></tr>" )
+                       .arg( node.node )
+                       .arg( formattedUnit( node.memTotal * 1024 ) )
+                       .arg( formattedUnit( node.memFree * 1024 ) )
+                       .arg( formattedUnit( node.filePages * 1024 ) )
+                       .arg( formattedUnit( node.anonPages * 1024 ) )
+                       .arg( locale->formatNumber( QString::number( node.numaHit ), false, 0 ) )
+                       .arg( locale->formatNumber( QString::number( node.numaMiss ), false, 0 ) )
+                       .arg( locale->formatNumber( QString::number( node.numaForeign ), false, 0 ) );
+        }
+        sysInfo += "</table>";
+    }
+
+    return sysInfo;
+}
+
+static QString pressureRow( const QString & name, const PressureLine & line, bool stalled )
+{
+    QString row = stalled ? "<tr class=\"stalled\"><td>" : "<tr><td>";
+    row += name + "</td>";
+    for ( int i = 0; i < 3; ++i )
+        row += "<td>" + i18nc( "percent", "%1%", KGlobal::locale()->formatNumber( line.avg[i], 2 ) ) + "</td>";
+    row += "<td>" + KGlobal::locale()->formatDuration( line.total / 1000 ) + "</td></tr>";
+    return row;
+}
+
+QString kio_sysinfoProtocol::pressureSection()
+{
+    const int stalled = m_pressure.fired();
+    QString rows;
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        PressureStats stats;
+        if ( !pressureStats( i, stats ) )
+            continue;
+
+        QString name;
+        switch ( i )
+        {
+        case Pressure::Cpu:
+            name = i18n( "CPU" );
+            break;
+        case Pressure::Memory:
+            name = i18n( "Memory" );
+            break;
+        case Pressure::Io:
+            name = i18n( "I/O" );
+            break;
+        }
+        const bool flagged = stalled & ( 1 << i );
+        rows += pressureRow( i18nc( "pressure stall, some tasks waiting", "%1 (some)", name ), stats.some, flagged );
+        // "full" is always 0 for the CPU at the system level
+        if ( stats.full.valid && i != Pressure::Cpu )
+            rows += pressureRow( i18nc( "pressure stall, all tasks waiting", "%1 (full)", name ), stats.full, false );
+    }
+    if ( rows.isEmpty() )
+        return QString();
+
+    QString sysInfo;
+    sysInfo += "<h2 id=\"pressure\">" + i18n( "Pressure" ) + "</h2>";
+    sysInfo += "<table>";
+    sysInfo += "<tr><th></th><th>" + i18n( "10 s" ) + "</th><th>" + i18n( "1 min" ) + "</th><th>" + i18n( "5 min" ) +
+               "</th><th>" + i18n( "Total stall" ) + "</th></tr>";
+    sysInfo += rows;
+    sysInfo += "</table>";
+    if ( stalled )
+        sysInfo += "<p class=\"stalled\">" + i18n( "Stalls above the trigger threshold since the last update." ) + "</p>";
 
-    sysInfo += "</div><div id=\"column1\">"; // second column
+    return sysInfo;
+}
 
-    // OS info
-    infoMessage( i18n( "Getting OS information...." ) );
+QString kio_sysinfoProtocol::netSection()
+{
+    QString sysInfo;
 
 //     // common folders
 //     sysInfo += "<h2 id=\"dirs\">" + i18n( "Common Folders" ) + "</h2>"; sysInfo += "<ul>";
@@ -298,8 +1073,7 @@ void kio_sysinfoProtocol::get( const KUrl & /*url*/ )
 //     sysInfo += "</ul>";
 
     // net info
-    infoMessage( i18n( "Looking up network status..." ) );
-    QString state = netStatus();
+    QString state = netStatus( m_snapshot.number( SysInfoSnapshot::NET_STATUS ) );
     if ( !state.isEmpty() ) // assume no network manager / networkstatus
     {
         sysInfo += "<h2 id=\"net\">" + i18n( "Network Status" ) + "</h2>";
@@ -308,551 +1082,639 @@ void kio_sysinfoProtocol::get( const KUrl & /*url*/ )
         sysInfo += "</ul>";
     }
 
-    // disk info
-    infoMessage( i18n( "Looking for disk information..." ) );
-    m_devices.clear();
-    sysInfo += "<h2 id=\"hdds\">" + i18n( "Disk Information" ) + "</h2>";
-    sysInfo += diskInfo();
-
-
-    // Send the data
-    content = content.arg( sysInfo ); // put the sysinfo text into the main box
-    data( content.toUtf8() );
-    data( QByteArray() ); // empty array means we're done sending the data
-    finished();
+    return sysInfo;
 }
 
-void kio_sysinfoProtocol::mimetype( const KUrl & /*url*/ )
+void kio_sysinfoProtocol::mimetype( const KUrl & url )
 {
-    mimeType( "application/x-sysinfo" );
+    if ( url.queryItem( "format" ) == "json" )
+        mimeType( "application/json" );
+    else
+        mimeType( "application/x-sysinfo" );
     finished();
 }
 
-static unsigned long int scan_one( const char* buff, const char *key )
+// JSON is sent in chunks of about this size
+#define JSON_CHUNK_SIZE 16384
+
+static const char * networkStatusName( Solid::Networking::Status status )
 {
-    const char *b = strstr( buff, key );
-    if ( !b )
-        return 0;
-    unsigned long int val = 0;
-    if ( sscanf( b + strlen( key ), ": %lu", &val ) != 1 )
-        return 0;
-    //kDebug(1242) << "scan_one " << key << " " << val;
-    return val;
+    switch ( status )
+    {
+    case Solid::Networking::Disconnecting:
+        return "disconnecting";
+    case Solid::Networking::Connecting:
+        return "connecting";
+    case Solid::Networking::Connected:
+        return "connected";
+    case Solid::Networking::Unconnected:
+        return "unconnected";
+    case Solid::Networking::Unknown:
+    default:
+        return "unknown";
+    }
 }
 
-static quint64 calculateFreeRam()
+static const char * chargeStateName( int state )
 {
-    FILE *fd = fopen( "/proc/meminfo", "rt" );
-    if ( !fd )
-        return 0;
-
-    QString MemInfoBuf = QTextStream(fd).readAll();
-    fclose( fd );
-
-    quint64 MemFree = scan_one( MemInfoBuf.toLatin1(), "MemFree" );
-    quint64 Buffers = scan_one( MemInfoBuf.toLatin1(), "Buffers" );
-    quint64 Cached  = scan_one( MemInfoBuf.toLatin1(), "Cached" );
-    quint64 Slab    = scan_one( MemInfoBuf.toLatin1(), "Slab" );
+    switch ( state )
+    {
+    case Solid::Battery::NoCharge:
+        return "none";
+    case Solid::Battery::Charging:
+        return "charging";
+    case Solid::Battery::Discharging:
+        return "discharging";
+    default:
+        return "unknown";
+    }
+}
 
-    MemFree += Cached + Buffers + Slab;
-    if ( MemFree > 50 * 1024 )
-        MemFree -= 50 * 1024;
-    return MemFree;
+/**
+ * The fields of a logged snapshot, raw and named as in SysInfoSnapshot
+ */
+static void loggedFields( JsonWriter & json, const SysInfoSnapshot & info, int results, qint64 timestamp )
+{
+    json.field( "timestamp", timestamp );
+    json.field( "collectors", results );
+    json.key( "numbers" );
+    json.beginObject();
+    for ( int i = 0; i < SysInfoSnapshot::NUMBER_COUNT; ++i )
+        if ( info.has( SysInfoSnapshot::Number( i ) ) )
+            json.field( SysInfoSnapshot::name( SysInfoSnapshot::Number( i ) ), info.number( SysInfoSnapshot::Number( i ) ) );
+    json.endObject();
+    json.key( "text" );
+    json.beginObject();
+    for ( int i = 0; i < SysInfoSnapshot::TEXT_COUNT; ++i )
+        if ( info.has( SysInfoSnapshot::Text( i ) ) )
+            json.field( SysInfoSnapshot::name( SysInfoSnapshot::Text( i ) ), info.utf8( SysInfoSnapshot::Text( i ) ) );
+    json.endObject();
 }
 
-void kio_sysinfoProtocol::memoryInfo()
+void kio_sysinfoProtocol::loggedGet( const KUrl & url )
 {
-    struct sysinfo info;
-    int retval = sysinfo( &info );
+    bool ok;
+    const qint64 at = url.queryItem( "at" ).toLongLong( &ok ) * 1000;
+    if ( !ok || !m_log )
+    {
+        error( KIO::ERR_DOES_NOT_EXIST, url.prettyUrl() );
+        return;
+    }
 
-    if ( retval !=-1 )
+    // older snapshots are in the rolled log
+    SnapshotLogReader reader;
+    qint64 offset = -1;
+    if ( reader.open( m_log->path() ) )
+        offset = reader.find( at );
+    if ( offset < 0 && reader.open( m_log->path() + ".1" ) )
+        offset = reader.find( at );
+    if ( offset < 0 )
     {
-        quint64 mem_unit = info.mem_unit;
+        error( KIO::ERR_DOES_NOT_EXIST, url.prettyUrl() );
+        return;
+    }
 
-        m_info[MEM_TOTALRAM] = formattedUnit( quint64(info.totalram) * mem_unit );
-        quint64 totalFree = calculateFreeRam() * 1024;
-        kDebug(1242) << "total " << totalFree << " free " << info.freeram << " unit " << mem_unit;
-        if ( totalFree > info.freeram * info.mem_unit || true )
-            m_info[MEM_FREERAM] = i18n("%1 (+ %2 Caches)",
-                                       formattedUnit( quint64(info.freeram) * mem_unit ),
-                                       formattedUnit( totalFree - info.freeram * mem_unit ));
-        else
-            m_info[MEM_FREERAM] = formattedUnit( quint64(info.freeram) * mem_unit );
+    SysInfoSnapshot & info = m_snapshot;
+    int results;
+    qint64 timestamp;
+    reader.read( offset, info, results, timestamp );
 
-        m_info[MEM_TOTALSWAP] = formattedUnit( quint64(info.totalswap) * mem_unit );
-        m_info[MEM_FREESWAP] = formattedUnit( quint64(info.freeswap) * mem_unit );
+    mimeType( "application/json" );
 
-        m_info[SYSTEM_UPTIME] = KIO::convertSeconds( info.uptime );
-    }
+    JsonWriter json;
+    json.beginObject();
+    json.field( "version", 1 );
+    loggedFields( json, info, results, timestamp );
+    json.endObject();
+
+    data( json.take() );
+    data( QByteArray() );
+    finished();
 }
 
-void kio_sysinfoProtocol::cpuInfo()
+void kio_sysinfoProtocol::loggedRangeGet( const KUrl & url )
 {
-    QString speed = readFromFile( "/proc/cpuinfo", "cpu MHz", ":" );
-
-    if ( speed.isNull() )    // PPC?
-        speed = readFromFile( "/proc/cpuinfo", "clock", ":" );
-
-    if ( speed.endsWith( "MHz", Qt::CaseInsensitive ) )
-        speed = speed.left( speed.length() - 3 );
-
-    m_info[CPU_SPEED] = speed;
-    m_info[CPU_CORES] = readFromFile( "/proc/cpuinfo", "processor", ":", true );
+    bool ok, toOk = true;
+    const qint64 from = url.queryItem( "from" ).toLongLong( &ok ) * 1000;
+    // to the end of that second
+    const qint64 to = url.hasQueryItem( "to" ) ? url.queryItem( "to" ).toLongLong( &toOk ) * 1000 + 999
+                                               : SnapshotLog::now();
+    if ( !ok || !toOk || !m_log )
+    {
+        error( KIO::ERR_DOES_NOT_EXIST, url.prettyUrl() );
+        return;
+    }
 
-    const char* const names[] = { "THM0", "THRM", "THM" };
-    for ( unsigned i = 0; i < sizeof(names)/sizeof(*names); ++i )
+    mimeType( "application/json" );
+
+    JsonWriter json;
+    json.beginObject();
+    json.field( "version", 1 );
+    json.key( "snapshots" );
+    json.beginArray();
+
+    // the rolled log holds the older snapshots
+    const QByteArray paths[] = { m_log->path() + ".1", m_log->path() };
+    SnapshotLogReader reader;
+    SysInfoSnapshot & info = m_snapshot;
+    int results;
+    qint64 timestamp;
+    for ( int i = 0; i < 2; ++i )
     {
-        m_info[CPU_TEMP] = readFromFile(QString("/proc/acpi/thermal_zone/%1/temperature").arg(names[i]), "temperature", ":");
-        const QString temp = m_info[CPU_TEMP].trimmed().remove(" C");
-        if (!temp.isEmpty())
+        if ( !reader.open( paths[i] ) )
+            continue;
+
+        // from the last record before the range, or the first if there is none
+        qint64 offset = reader.find( from );
+        if ( offset < 0 )
+            offset = reader.first();
+        for ( ; offset >= 0; offset = reader.next( offset ) )
         {
-            m_info[CPU_TEMP] = i18nc("temperature", "%1 °C", temp.toInt());
-            break;
+            reader.read( offset, info, results, timestamp );
+            if ( timestamp < from )
+                continue;
+            if ( timestamp > to )
+                break;
+            json.beginObject();
+            loggedFields( json, info, results, timestamp );
+            json.endObject();
+            if ( json.pending() > JSON_CHUNK_SIZE )
+                data( json.take() );
         }
     }
 
-    m_info[CPU_MODEL] = readFromFile( "/proc/cpuinfo", "model name", ":" );
-    if ( m_info[CPU_MODEL].isNull() ) // PPC?
-         m_info[CPU_MODEL] = readFromFile( "/proc/cpuinfo", "cpu", ":" );
+    json.endArray();
+    json.endObject();
+    data( json.take() );
+    data( QByteArray() );
+    finished();
 }
 
-QString kio_sysinfoProtocol::diskInfo()
+void kio_sysinfoProtocol::jsonGet()
 {
-    QString result = "<table>\n<tr><th></th><th>" + i18n( "Device" ) + "</th><th>" + i18n( "Filesystem" ) + "</th><th>" +
-                     i18n( "Total space" ) + "</th><th>" + i18n( "Available space" ) + "</th><th></th></tr>\n";
-
-    if ( fillMediaDevices() )
+    mimeType( "application/json" );
+
+    JsonWriter json;
+    json.beginObject();
+    json.field( "version", 1 );
+
+    // the snapshot the page is rendered from, its values are raw already;
+    // without a sampler the collectors run on the pool as for the page
+    const SysInfoSnapshot & info = m_snapshot;
+    QTime started;
+    started.start();
+    m_snapshot.clear();
+    const int sampled = readSampler();
+    const CollectorBatchPtr batch = startCollectors( sampled < 0 ? ( 1 << COLL_COUNT ) - 1 : 0 );
+    m_snapshot.setNumber( SysInfoSnapshot::NET_STATUS, Solid::Networking::status() );
+    bool haveGl = false;
+    for ( int i = 0; i < COLL_COUNT; ++i )
     {
-        for ( QList<DiskInfo>::ConstIterator it = m_devices.constBegin(); it != m_devices.constEnd(); ++it )
-        {
-            QString tooltip = i18n("Press the right mouse button for more options (such as Mount or Eject.)");
-
-            DiskInfo di = ( *it );
-            unsigned int percent = 0;
-            quint64 usage = di.total - di.avail;
-            if (di.total)
-                percent = usage / ( di.total / 100);
-
-            QString media = "file://" + di.deviceNode;
-
-            QString unmount;
-            if (di.removable)
-                unmount = QString("<a href=\"#unmount=%1\">%2</a>").
-                          arg( di.id ).arg( icon( "media-eject", 16 ) );
+        const bool result = collected( batch, sampled, i, started, m_snapshot );
+        if ( i == COLL_GL )
+            haveGl = result;
+    }
 
-            result += QString( "<tr><td rowspan=\"2\">%1</td><td><a href=\"%2\" title=\"%7\">%3</a></td>" \
-                               "<td>%4</td><td>%5</td><td>%6</td><td rowspan=\"2\">%8</td></tr>\n" ).
-                      arg( hdicon() ).arg( htmlQuote(media) ).arg( htmlQuote(di.label) ).arg( di.fsType ).
-                      arg( di.total ? formattedUnit( di.total) : QString::null).
-                      arg( di.mounted ? formattedUnit( di.avail ) : QString::null).
-                      arg( htmlQuote( tooltip ) ).
-                      arg(unmount);
+    json.key( "os" );
+    json.beginObject();
+    json.field( "sysname", info.utf8( SysInfoSnapshot::OS_SYSNAME ) );
+    json.field( "release", info.utf8( SysInfoSnapshot::OS_RELEASE ) );
+    json.field( "version", info.utf8( SysInfoSnapshot::OS_VERSION ) );
+    json.field( "machine", info.utf8( SysInfoSnapshot::OS_MACHINE ) );
+    json.field( "hostname", info.utf8( SysInfoSnapshot::OS_HOSTNAME ) );
+    json.endObject();
+
+    json.key( "software" );
+    json.beginObject();
+    json.field( "qt", info.utf8( SysInfoSnapshot::QT5_VERSION ).trimmed() );
+    json.field( "frameworks", info.utf8( SysInfoSnapshot::KF5_VERSION ).trimmed() );
+    json.field( "plasma", info.utf8( SysInfoSnapshot::PLASMA_VERSION ).trimmed() );
+    json.field( "applications", info.utf8( SysInfoSnapshot::KDEAPPS_VERSION ).trimmed() );
+    json.field( "wayland", info.utf8( SysInfoSnapshot::WAYLAND_VER ).trimmed() );
+    json.endObject();
+
+    if ( haveGl )
+    {
+        json.key( "display" );
+        json.beginObject();
+        json.field( "vendor", info.utf8( SysInfoSnapshot::GFX_VENDOR ) );
+        json.field( "model", info.utf8( SysInfoSnapshot::GFX_MODEL ) );
+        json.field( "driver_2d", info.utf8( SysInfoSnapshot::GFX_2D_DRIVER ) );
+        json.field( "driver_3d", info.utf8( SysInfoSnapshot::GFX_3D_DRIVER ) );
+        json.field( "mesa_version", info.utf8( SysInfoSnapshot::GFX_MESA_VERSION ) );
+        // only known to be off for a software renderer
+        json.key( "accelerated" );
+        if ( info.has( SysInfoSnapshot::GFX_ACCELERATED ) )
+            json.value( info.number( SysInfoSnapshot::GFX_ACCELERATED ) != 0 );
+        else
+            json.null();
+        json.endObject();
+    }
 
-            result += QString("<tr><td colspan=\"4\" %1>").arg( di.mounted ? "class=\"bar\"" : "");
-            if (di.mounted)
+    CpuInfoTable cpus;
+    if ( cpus.read() )
+    {
+        json.key( "cpu" );
+        json.beginObject();
+        json.field( "model", cpus.model( 0 ) );
+        json.field( "count", cpus.count() );
+        json.field( "packages", cpus.packageCount() );
+
+        const CpuFreq * freq = cpuFreq();
+        if ( freq )
+        {
+            json.key( "cpufreq" );
+            json.beginArray();
+            Q_FOREACH ( const CpuFreqPolicy & policy, freq->policies() )
             {
-                QColor c;
-                c.setHsv(100-percent, 180, 230);
-                QString dp = formattedUnit(usage).replace(" ", "&nbsp;");
-                QString dpl, dpr;
-                if (percent >= 50)
-                    dpl = dp;
-                else
-                    dpr = "<span>" + dp + "</span>";
-                result += QString("<div><span class=\"filled\" style=\"width: %1%; background-color: %4\">"
-                                  "%2</span>%3</div>\n")
-                          .arg(percent).arg(dpl).arg(dpr).arg(c.name());
+                json.beginObject();
+                json.key( "cpus" );
+                json.beginArray();
+                Q_FOREACH ( int cpu, policy.cpus )
+                    json.value( cpu );
+                json.endArray();
+                json.field( "min_khz", quint64( policy.minKHz ) );
+                json.field( "cur_khz", quint64( policy.curKHz ) );
+                json.field( "max_khz", quint64( policy.maxKHz ) );
+                json.field( "governor", policy.governor );
+                if ( !policy.preference.isEmpty() )
+                    json.field( "energy_performance_preference", policy.preference );
+                json.endObject();
             }
-            result += "</td></tr>\n";
+            json.endArray();
         }
-    }
-
-    result += "</table>";
 
-    return result;
-}
+        const CpuTopology & topology = CpuTopology::system();
+        json.key( "topology" );
+        json.beginObject();
+        json.field( "sockets", topology.packageCount() );
+        json.field( "nodes", topology.nodeCount() );
+        json.field( "cores", topology.coreCount() );
+        json.field( "threads_per_core", topology.threadsPerCore() );
+        json.key( "caches" );
+        json.beginArray();
+        Q_FOREACH ( const CpuCacheInfo & cache, topology.caches() )
+        {
+            json.beginObject();
+            json.field( "level", cache.level );
+            json.field( "type", cache.type == 'd' ? "data" : cache.type == 'i' ? "instruction" : "unified" );
+            json.field( "size", cache.size );
+            json.field( "instances", cache.instances );
+            json.field( "shared_by", cache.sharedBy );
+            json.endObject();
+        }
+        json.endArray();
+        json.endObject();
 
-#ifdef HAVE_GLXCHOOSEVISUAL
-#include <GL/glx.h>
-#endif
-
-//-------------------------------------
-bool hasDirectRendering ( QString &renderer ) {
-    renderer = QString::null;
-
-    Display *dpy = QX11Info::display();
-    if (!dpy) return false;
-
-#ifdef HAVE_GLXCHOOSEVISUAL
-    int attribSingle[] = {
-        GLX_RGBA,
-        GLX_RED_SIZE,   1,
-        GLX_GREEN_SIZE, 1,
-        GLX_BLUE_SIZE,  1,
-        None
-    };
-    int attribDouble[] = {
-      GLX_RGBA,
-      GLX_RED_SIZE, 1,
-      GLX_GREEN_SIZE, 1,
-      GLX_BLUE_SIZE, 1,
-      GLX_DOUBLEBUFFER,
-      None
-    };
-
-    XVisualInfo* visinfo = glXChooseVisual (
-        dpy, QApplication::desktop()->primaryScreen(), attribSingle
-    );
-    if (visinfo)
-    {
-        GLXContext ctx = glXCreateContext ( dpy, visinfo, NULL, True );
-        if (glXIsDirect(dpy, ctx))
-        {
-            glXDestroyContext (dpy,ctx);
-            return true;
-        }
-
-        XSetWindowAttributes attr;
-        unsigned long mask;
-        Window root;
-        XVisualInfo *visinfo;
-        int width = 100, height = 100;
-        int scrnum = QApplication::desktop()->primaryScreen();
-
-        root = RootWindow(dpy, scrnum);
-
-        visinfo = glXChooseVisual(dpy, scrnum, attribSingle);
-        if (!visinfo)
-        {
-            visinfo = glXChooseVisual(dpy, scrnum, attribDouble);
-            if (!visinfo)
+        const CpuStat & stat = cpuStat();
+        if ( ( m_haveSamplerData || m_cpuStat.sample() ) && stat.intervalCount() )
+        {
+            // per state, one percentage per CPU since the previous request
+            json.key( "utilization" );
+            json.beginObject();
+            for ( int state = 0; state < CpuStat::STATE_COUNT; ++state )
             {
-                fprintf(stderr, "Error: could not find RGB GLX visual\n");
-                return false;
+                json.key( CpuStat::stateName( CpuStat::State( state ) ) );
+                json.beginArray();
+                for ( int cpu = 0; cpu < stat.cpuCount(); ++cpu )
+                {
+                    if ( stat.online( cpu ) )
+                        json.value( double( stat.percent( cpu, CpuStat::State( state ) ) ) );
+                    else
+                        json.null();
+                }
+                json.endArray();
+                if ( json.pending() > JSON_CHUNK_SIZE )
+                    data( json.take() );
             }
+            json.endObject();
         }
-
-        attr.background_pixel = 0;
-        attr.border_pixel = 0;
-        attr.colormap = XCreateColormap(dpy, root, visinfo->visual, AllocNone);
-        attr.event_mask = StructureNotifyMask | ExposureMask;
-        mask = CWBackPixel | CWBorderPixel | CWColormap | CWEventMask;
-
-        Window win = XCreateWindow(dpy, root, 0, 0, width, height,
-                                   0, visinfo->depth, InputOutput,
-                                   visinfo->visual, mask, &attr);
-
-        if ( glXMakeCurrent(dpy, win, ctx))
-            renderer = (const char *) glGetString(GL_RENDERER);
-        XDestroyWindow(dpy, win);
-
-        glXDestroyContext (dpy,ctx);
-        return false;
-    }
-    else
-    {
-        return false;
+        json.key( "cpus" );
+        json.beginArray();
+        for ( int i = 0; i < cpus.count(); ++i )
+        {
+            const CpuInfoRecord & cpu = cpus.at( i );
+            json.beginObject();
+            json.field( "processor", cpu.processor );
+            json.field( "physical_id", cpu.physicalId );
+            json.field( "core_id", cpu.coreId );
+            json.field( "node", topology.nodeOf( cpu.processor ) );
+            if ( const CpuFreqPolicy * policy = freq ? freq->policyOf( cpu.processor ) : 0 )
+                json.field( "cur_khz", quint64( policy->curKHz ) );
+            json.field( "mhz", double( cpu.mhz ) );
+            json.endObject();
+            if ( json.pending() > JSON_CHUNK_SIZE )
+                data( json.take() );
+        }
+        json.endArray();
+        json.endObject();
     }
-#else
-    return false;
-#endif
-}
 
-
-bool kio_sysinfoProtocol::glInfo()
-{
-    /* This leaks like sieve. Since gfx cards usually don't happen
-       to change to something else while the computer is running,
-       run this just once and keep the results. */
-    static bool beenhere = false;
-    static bool prevresult = false;
-    if( beenhere )
-        return prevresult;
-    beenhere = true;
-
-#ifdef HAVE_HD
-    /* Prepare HD */
-    static hd_data_t hd_data;
-    static bool inited_hd = false;
-    if ( !inited_hd )
+    // temperatures in degrees Celsius, fan speeds in RPM
+    json.key( "sensors" );
+    json.beginArray();
+    Q_FOREACH ( const SensorReading & reading, sensorReadings() )
     {
-        memset(&hd_data, 0, sizeof(hd_data));
-        inited_hd = true;
+        json.beginObject();
+        json.field( "chip", reading.chip );
+        json.field( "label", reading.label );
+        if ( reading.kind == SensorReading::Fan )
+        {
+            json.field( "type", "fan" );
+            json.field( "value", reading.value );
+        }
+        else
+        {
+            json.field( "type", "temperature" );
+            json.field( "value", reading.value / 1000.0 );
+        }
+        json.endObject();
     }
+    json.endArray();
 
-    if (!hd_list(&hd_data, hw_display, 1, NULL))
-        return false;
-
-    hd_t *hd = hd_get_device_by_idx(&hd_data, hd_display_adapter(&hd_data));
-#endif
-
-    /* Build list of all loaded Xorg modules */
-    QStringList loaded_modules;
-    QFile file("/var/log/Xorg.0.log");
-    if (file.exists() && file.open(QIODevice::ReadOnly)) {
-        QTextStream stream(&file);
-        QString line;
-
-        while (!stream.atEnd()) {
-            line = stream.readLine();
-            QRegExp rx_mod_load("\\(II\\) LoadModule: \"([\\S]+)\"");
-            QRegExp rx_mod_unload("\\(II\\) UnloadModule: \"([\\S]+)\"");
-            if (rx_mod_load.indexIn(line) > -1) {
-                loaded_modules.append(rx_mod_load.cap(1));
-            } else if (rx_mod_unload.indexIn(line) > -1) {
-                loaded_modules.removeOne(rx_mod_unload.cap(1));
-            }
+    if ( info.has( SysInfoSnapshot::MEM_TOTALRAM ) )
+    {
+        json.field( "uptime", info.number( SysInfoSnapshot::SYSTEM_UPTIME ) );
+        json.key( "memory" );
+        json.beginObject();
+        json.field( "total", info.number( SysInfoSnapshot::MEM_TOTALRAM ) );
+        json.field( "free", info.number( SysInfoSnapshot::MEM_FREERAM ) );
+        json.field( "available", info.number( SysInfoSnapshot::MEM_AVAILABLE ) );
+        json.field( "cached", info.number( SysInfoSnapshot::MEM_CACHED ) );
+        json.field( "shmem", info.number( SysInfoSnapshot::MEM_SHMEM ) );
+        json.field( "slab_unreclaimable", info.number( SysInfoSnapshot::MEM_SUNRECLAIM ) );
+        if ( info.has( SysInfoSnapshot::MEM_HUGEPAGES_TOTAL ) )
+        {
+            json.field( "hugepages_total", info.number( SysInfoSnapshot::MEM_HUGEPAGES_TOTAL ) );
+            json.field( "hugepages_free", info.number( SysInfoSnapshot::MEM_HUGEPAGES_FREE ) );
+        }
+        json.field( "swap_total", info.number( SysInfoSnapshot::MEM_TOTALSWAP ) );
+        json.field( "swap_free", info.number( SysInfoSnapshot::MEM_FREESWAP ) );
+        if ( info.has( SysInfoSnapshot::MEM_ZSWAP ) )
+        {
+            json.field( "zswap", info.number( SysInfoSnapshot::MEM_ZSWAP ) );
+            json.field( "zswapped", info.number( SysInfoSnapshot::MEM_ZSWAPPED ) );
+        }
+        if ( info.has( SysInfoSnapshot::MEM_ZRAM_USED ) )
+        {
+            json.field( "zram_used", info.number( SysInfoSnapshot::MEM_ZRAM_USED ) );
+            json.field( "zram_data", info.number( SysInfoSnapshot::MEM_ZRAM_DATA ) );
         }
+        json.endObject();
     }
 
-    /* Names of possible 2D drivers. We will look for them in cached modules */
-    QStringList possible_2d_drivers;
-#ifdef HAVE_HD
-    if (hd) {
-        driver_info_t *di = hd->driver_info;
-        for (di = di; di; di = di->next) {
-            if (di->any.type == di_x11) {
-                possible_2d_drivers.append(di->x11.server);
-            } else if (di->any.type == di_module && di->module.names) {
-                possible_2d_drivers.append(di->module.names->str);
-            }
+    // stall percentages over 10, 60 and 300 s, total stall time in microseconds
+    json.key( "pressure" );
+    json.beginObject();
+    const int stalled = m_pressure.fired();
+    for ( int i = 0; i < Pressure::RESOURCE_COUNT; ++i )
+    {
+        PressureStats stats;
+        if ( !pressureStats( i, stats ) )
+            continue;
+        json.key( Pressure::resourceName( Pressure::Resource( i ) ) );
+        json.beginObject();
+        for ( int kind = 0; kind < 2; ++kind )
+        {
+            const PressureLine & line = kind ? stats.full : stats.some;
+            if ( !line.valid )
+                continue;
+            json.key( kind ? "full" : "some" );
+            json.beginObject();
+            json.field( "avg10", double( line.avg[0] ) );
+            json.field( "avg60", double( line.avg[1] ) );
+            json.field( "avg300", double( line.avg[2] ) );
+            json.field( "total_us", line.total );
+            json.endObject();
         }
+        if ( m_pressure.fd( Pressure::Resource( i ) ) >= 0 )
+            json.field( "triggered", bool( stalled & ( 1 << i ) ) );
+        json.endObject();
     }
-#endif
-    possible_2d_drivers << "fglrx" << "intel" << "nouveau" << "nv" << "nvidia" << "openchrome" << "radeon" << "radeonhd" << "vboxvideo";
-    possible_2d_drivers << "vesa" << "fbdev";
+    json.endObject();
 
-    /* Find first of possible 2D drivers that is actually loaded */
-    QString driver = QString::null;
-    for (int i = 0; i < possible_2d_drivers.size(); ++i) {
-        QString curr_driver = possible_2d_drivers.at(i);
-        if (loaded_modules.contains(curr_driver)) {
-            m_info[GFX_2D_DRIVER] = curr_driver;
-            driver = curr_driver; /* FIXME */
-            break;
+    // per NUMA node, sizes in KiB, allocation counters in pages
+    if ( NumaInfo::read( m_numaNodes ) )
+    {
+        json.key( "numa" );
+        json.beginArray();
+        Q_FOREACH ( const NumaNodeInfo & node, m_numaNodes )
+        {
+            json.beginObject();
+            json.field( "node", node.node );
+            json.field( "mem_total", node.memTotal );
+            json.field( "mem_free", node.memFree );
+            json.field( "file_pages", node.filePages );
+            json.field( "anon_pages", node.anonPages );
+            json.field( "numa_hit", node.numaHit );
+            json.field( "numa_miss", node.numaMiss );
+            json.field( "numa_foreign", node.numaForeign );
+            json.field( "interleave_hit", node.interleaveHit );
+            json.field( "local_node", node.localNode );
+            json.field( "other_node", node.otherNode );
+            json.endObject();
         }
+        json.endArray();
     }
 
-    /* Grab OpenGL info */
-    QString opengl_vendor = QString::null;
-    QString opengl_renderer = QString::null;
-    QString opengl_version = QString::null;
-    QString opengl_mesa = QString::null;
-    /* FIXME: unsafe, replace popen with QProcess? */
-    FILE *fd = popen("glxinfo", "r");
-    if (fd) {
-        QTextStream is(fd);
-        while (!is.atEnd()) {
-            QString line = is.readLine();
-            if (line.startsWith("OpenGL vendor string:")) {
-                opengl_vendor = line.section(':', 1, 1);
-            } else if (line.startsWith("OpenGL renderer string:")) {
-                opengl_renderer = line.section(':', 1, 1);
-            } else if (line.startsWith("OpenGL version string:")) {
-                opengl_version = line.section(':', 1, 1);
-            }
+    // all of /proc/meminfo under the kernel's names, in KiB (HugePages_* in pages)
+    MemInfo mem;
+    if ( mem.read() )
+    {
+        json.key( "meminfo" );
+        json.beginObject();
+        for ( int i = 0; i < MemInfo::fieldCount(); ++i )
+        {
+            if ( mem.has( i ) )
+                json.field( MemInfo::fieldName( i ), mem.value( i ) );
         }
+        json.endObject();
     }
-    if (fd) {
-        /* FIXME: this is hack to do not let QTextStream touch fd after closing
-         * it. Prevents whole kio_sysinfo from crashing */
-        pclose(fd);
-    }
-    QRegExp rx("Mesa (\\S+)");
-    if (rx.indexIn(opengl_version) > -1) {
-        opengl_mesa = rx.cap(1);
-    }
-
-    /* As first choice, use OpenGL info */
-    m_info[GFX_VENDOR] = opengl_vendor;
-    m_info[GFX_MODEL] = opengl_renderer;    
-
-    /* Determine 3D driver from OpenGL info */
-    QRegExp rx_g("Gallium.+on ([\\S]+)");
-    if (opengl_renderer.contains("Software Rasterizer")) { /* swrast */
-        m_info[GFX_3D_DRIVER] = QString("%1 (%2)").arg("swrast").arg(i18n("No 3D Acceleration"));
-    } else if (rx_g.indexIn(opengl_renderer) > -1) { /* Gallium */
-        m_info[GFX_MODEL] = rx_g.cap(1);
-        if (opengl_vendor.contains("R300")) {
-            m_info[GFX_VENDOR] = GFX_VENDOR_ATI;
-            m_info[GFX_3D_DRIVER] = "R300";
-        } else if (opengl_vendor.contains("R600")) {
-            m_info[GFX_VENDOR] = GFX_VENDOR_ATI;
-            m_info[GFX_3D_DRIVER] = "R600";
-        } else if (opengl_vendor.contains("nouveau")) {
-            m_info[GFX_VENDOR] = GFX_VENDOR_NVIDIA;
-            m_info[GFX_3D_DRIVER] = "nouveau";
-        } else {
-            m_info[GFX_3D_DRIVER] = i18n("Unknown");
-        }
-        m_info[GFX_3D_DRIVER] += " Gallium";
-    } else if (opengl_renderer.contains("Mesa DRI")) { /* Classic Mesa */
-        QRegExp rx_r("(R[0-9]00) \\(([^\\)]+)\\)");
-        if (rx_r.indexIn(opengl_renderer) > -1) {
-            m_info[GFX_VENDOR] = GFX_VENDOR_ATI;
-            m_info[GFX_MODEL] = rx_r.cap(2);
-            m_info[GFX_3D_DRIVER] = rx_r.cap(1);
-        } else {
-            m_info[GFX_3D_DRIVER] = i18n("Mesa");
-        }
-        m_info[GFX_3D_DRIVER] += " classic";
-    } else if (opengl_vendor.contains("ATI") || opengl_vendor.contains("Advanced Micro Devices")) { /* Proprietary ATI */
-        m_info[GFX_VENDOR] = GFX_VENDOR_ATI;
-        m_info[GFX_MODEL] = opengl_renderer;
-        m_info[GFX_3D_DRIVER] = "ATI";
-    } else if (opengl_vendor.contains("NVIDIA")) { /* Proprietary NVIDIA */
-        m_info[GFX_VENDOR] = GFX_VENDOR_NVIDIA;
-        m_info[GFX_MODEL] = opengl_renderer;
-        QRegExp rx_n("(NVIDIA [0-9\\.]+)");
-        if (rx_n.indexIn(opengl_version) > -1) {
-            m_info[GFX_3D_DRIVER] = rx_n.cap(1);
-        } else {
-            m_info[GFX_3D_DRIVER] = "NVIDIA";
-        }
-    }
-    
-    if (!opengl_mesa.isNull())
-        m_info[GFX_3D_DRIVER] += QString(" (%1)").arg(opengl_mesa);
-
-#ifdef HAVE_HD
-    /* Using HD (when possible) should gave the best result */
-    if (hd) {
-        m_info[GFX_VENDOR] = hd->vendor.name;
-        /* GFX_MODEL maybe empty with newer models */
-        if (!!hd->device.name) {
-            m_info[GFX_MODEL] = hd->device.name;
-        }
-    }
-#endif
-
-    prevresult = true;
-    return true;
+    data( json.take() );
 
-#if 0
-#ifdef HAVE_HD
-    QString renderer;
-    bool dri = hasDirectRendering( renderer );
-
-    if (!driver.isNull())
+    const QList<Solid::Device> & power = Solid::Device::listFromQuery( SOLID_BATTERY_AC_PREDICATE );
+    json.key( "power" );
+    json.beginArray();
+    Q_FOREACH ( const Solid::Device & device, power )
     {
-        if (dri)
-            m_info[GFX_3D_DRIVER] = i18n("%1 (3D Support)", driver);
-        else
+        json.beginObject();
+        if ( const Solid::Battery * battery = device.as<Solid::Battery>() )
         {
-            if ( renderer.contains( "Mesa GLX Indirect" ) )
-                m_info[GFX_3D_DRIVER] = i18n("%1 (No 3D Support)", driver);
-            else
-                m_info[GFX_3D_DRIVER] = driver;
+            json.field( "type", "battery" );
+            json.field( "plugged", battery->isPlugged() );
+            json.field( "charge_percent", battery->chargePercent() );
+            json.field( "charge_state", chargeStateName( battery->chargeState() ) );
+            json.field( "rechargeable", battery->isRechargeable() );
         }
+        else if ( const Solid::AcAdapter * ac = device.as<Solid::AcAdapter>() )
+        {
+            json.field( "type", "ac" );
+            json.field( "plugged", ac->isPlugged() );
+        }
+        json.endObject();
     }
-    else
-        m_info[GFX_3D_DRIVER] = i18n( "Unknown" );
-#else
-    m_info[GFX_3D_DRIVER] = opengl_version;
-#endif
+    json.endArray();
 
-    prevresult = true;
-    return true;
-#endif
-}
-
-bool kio_sysinfoProtocol::kdeInfo() 
-{
-    /* Grab KF5 & Qt5 info */
-    QString qt5_version = QString::null;
-    QString kf5_version = QString::null;
-    /* FIXME: unsafe, replace popen with QProcess? */
-    FILE *fd = popen("kf5-config --version", "r");
-    if (fd) {
-        QTextStream is(fd);
-        while (!is.atEnd()) {
-            QString line = is.readLine();
-            if (line.startsWith("Qt:")) {
-                qt5_version = line.section(':', 1, 1);
-            } else if (line.startsWith("KDE Frameworks:")) {
-                kf5_version = line.section(':', 1, 1);
+    json.field( "network", networkStatusName( Solid::Networking::Status( info.number( SysInfoSnapshot::NET_STATUS ) ) ) );
+
+    m_devices.clear();
+    json.key( "disks" );
+    json.beginArray();
+    if ( fillMediaDevices() )
+    {
+        for ( QList<DiskInfo>::ConstIterator it = m_devices.constBegin(); it != m_devices.constEnd(); ++it )
+        {
+            json.beginObject();
+            json.field( "id", it->id );
+            json.field( "device", it->deviceNode );
+            json.field( "label", it->label );
+            json.field( "mount_point", it->mountPoint );
+            json.field( "fs_type", it->fsType );
+            json.field( "mounted", it->mounted );
+            json.field( "removable", it->removable );
+            json.field( "unresponsive", it->unresponsive );
+            if ( it->io.valid )
+            {
+                json.key( "io" );
+                json.beginObject();
+                json.field( "read_bytes_per_sec", it->io.readBytes );
+                json.field( "write_bytes_per_sec", it->io.writeBytes );
+                json.field( "reads_per_sec", it->io.readOps );
+                json.field( "writes_per_sec", it->io.writeOps );
+                json.field( "queue_depth", it->io.queueDepth );
+                json.field( "service_time_ms", it->io.serviceTime );
+                json.field( "utilization", it->io.utilization );
+                json.endObject();
             }
+            json.field( "total", it->total );
+            json.field( "avail", it->avail );
+            json.endObject();
+            if ( json.pending() > JSON_CHUNK_SIZE )
+                data( json.take() );
         }
     }
-    if (fd) {
-        /* FIXME: this is hack to do not let QTextStream touch fd after closing
-         * it. Prevents whole kio_sysinfo from crashing */
-        pclose(fd);
-    }
-    
-    m_info[QT5_VERSION] = qt5_version;
-    m_info[KF5_VERSION] = kf5_version;
-    
-    /* Grab KF5 & Qt5 info */
-    QString kdeapps_version = QString::null;
-    /* FIXME: unsafe, replace popen with QProcess? */
-    FILE *fd1 = popen("dolphin --version", "r");
-    if (fd) {
-        QTextStream is(fd1);
-        while (!is.atEnd()) {
-            QString line = is.readLine();
-            if (line.startsWith("dolphin")) {
-                kdeapps_version = line.section(' ', 1, 1);
-            }
+    json.endArray();
+
+    json.endObject();
+    data( json.take() );
+    data( QByteArray() ); // empty array means we're done sending the data
+    finished();
+}
+
+static QString ioCells( const DiskIoRates & io )
+{
+    if ( !io.valid )
+        return "<td></td><td></td><td></td>";
+
+    const KLocale * locale = KGlobal::locale();
+    return QString( "<td class=\"io\">%1" BR "%2</td><td class=\"io\">%3" BR "%4</td><td class=\"io\">%5" BR "%6</td>" ).
+           arg( i18nc( "disk throughput", "%1/s", formattedUnit( quint64( io.readBytes ) ) ) ).
+           arg( i18nc( "disk I/O operations per second", "%1 IOPS", locale->formatNumber( io.readOps, 0 ) ) ).
+           arg( i18nc( "disk throughput", "%1/s", formattedUnit( quint64( io.writeBytes ) ) ) ).
+           arg( i18nc( "disk I/O operations per second", "%1 IOPS", locale->formatNumber( io.writeOps, 0 ) ) ).
+           arg( locale->formatNumber( io.queueDepth, 2 ) ).
+           arg( i18nc( "average disk service time", "%1 ms", locale->formatNumber( io.serviceTime, 1 ) ) );
+}
+
+QString kio_sysinfoProtocol::diskInfo()
+{
+    QString result = "<table>\n<tr><th></th><th>" + i18n( "Device" ) + "</th><th>" + i18n( "Filesystem" ) + "</th><th>" +
+                     i18n( "Total space" ) + "</th><th>" + i18n( "Available space" ) + "</th><th>" +
+                     i18nc( "disk I/O", "Read" ) + "</th><th>" + i18nc( "disk I/O", "Write" ) + "</th><th>" +
+                     i18nc( "average disk queue depth and service time", "Queue" ) + "</th><th></th></tr>\n";
+
+    if ( fillMediaDevices() )
+    {
+        for ( QList<DiskInfo>::ConstIterator it = m_devices.constBegin(); it != m_devices.constEnd(); ++it )
+        {
+            QString history;
+            if ( it->mounted && !it->unresponsive )
+                history = sparkline( diskHistory( it->mountPoint ), it->total,
+                                     i18np( "Space used over the last minute", "Space used over the last %1 minutes", historyMinutes() ) );
+            result += diskRows( *it, history );
         }
     }
-    if (fd1) {
-        /* FIXME: this is hack to do not let QTextStream touch fd after closing
-         * it. Prevents whole kio_sysinfo from crashing */
-        pclose(fd1);
-    }
-    
-    m_info[KDEAPPS_VERSION] = kdeapps_version;
-    
-    return true;
-}    
 
-void kio_sysinfoProtocol::waylandInfo()
+    result += "</table>";
+
+    return result;
+}
+
+QString kio_sysinfoProtocol::diskRows( const DiskInfo & di, const QString & spaceHistory )
 {
-    QFile file("/usr/include/wayland-version.h");
-    if (file.exists()) {
-        m_info[WAYLAND_VER] = readFromFile ( "/usr/include/wayland-version.h", "#define WAYLAND_VERSION", "\"" );
+    unsigned int percent = 0;
+    quint64 usage = di.total - di.avail;
+    if (di.total)
+        percent = usage / ( di.total / 100);
+
+    QString avail;
+    if (di.unresponsive)
+        avail = i18nc( "mount point not answering", "unresponsive" );
+    else if (di.mounted)
+        avail = formattedUnit( di.avail ) + spaceHistory;
+
+    QString result = di.headCells + QString( "<td>%1</td><td>%2</td>" ).
+                     arg( di.total ? formattedUnit( di.total) : QString::null).
+                     arg( avail ) + ioCells( di.io ) + di.tailCells;
+
+    const bool bar = di.mounted && !di.unresponsive;
+    result += QString("<tr><td colspan=\"7\" %1>").arg( bar ? "class=\"bar\"" : "");
+    if (bar)
+    {
+        QColor c;
+        c.setHsv(100-percent, 180, 230);
+        QString dp = formattedUnit(usage).replace(" ", "&nbsp;");
+        QString dpl, dpr;
+        if (percent >= 50)
+            dpl = dp;
+        else
+            dpr = "<span>" + dp + "</span>";
+        result += QString("<div><span class=\"filled\" style=\"width: %1%; background-color: %4\">"
+                          "%2</span>%3</div>\n")
+                  .arg(percent).arg(dpl).arg(dpr).arg(c.name());
     }
+    result += "</td></tr>\n";
+    return result;
 }
 
-
-QString kio_sysinfoProtocol::hdicon() const
+void kio_sysinfoProtocol::diskCells( DiskInfo & di )
 {
-    QString hdimagePath = "file://" + KStandardDirs::locate( "data", "sysinfo/about/images/hdd.png");
-    return QString( "<img src=\"%1\" width=\"32\" height=\"32\" valign=\"bottom\"/>").arg( hdimagePath );
+    const QString tooltip = htmlQuote( i18n("Press the right mouse button for more options (such as Mount or Eject.)") );
+    const QString media = "file://" + di.deviceNode;
+    di.headCells = QString( "<tr><td rowspan=\"2\">%1</td><td><a href=\"%2\" title=\"%3\">%4</a></td><td>%5</td>" ).
+                   arg( hdicon() ).arg( htmlQuote(media) ).arg( tooltip ).arg( htmlQuote(di.label) ).arg( di.fsType );
+
+    QString unmount;
+    if (di.removable)
+        unmount = QString("<a href=\"#unmount=%1\">%2</a>").
+                  arg( di.id ).arg( icon( "media-eject", 16 ) );
+    di.tailCells = QString( "<td rowspan=\"2\">%1</td></tr>\n" ).arg( unmount );
 }
 
-QString kio_sysinfoProtocol::icon( const QString & name, int size ) const
+QString kio_sysinfoProtocol::hdicon()
 {
-    QString path = KIconLoader::global()->iconPath( name, -size );
-    return QString( "<img src=\"file:%1\" width=\"%2\" height=\"%3\" valign=\"bottom\"/>" )
-        .arg( htmlQuote(path) ).arg( size ).arg( size );
+    static QString img;
+    if ( img.isNull() )
+    {
+        QString hdimagePath = "file://" + locateData( "sysinfo/about/images/hdd.png" );
+        img = QString( "<img src=\"%1\" width=\"32\" height=\"32\" valign=\"bottom\"/>").arg( hdimagePath );
+    }
+    return img;
 }
 
-void kio_sysinfoProtocol::osInfo()
+QString kio_sysinfoProtocol::icon( const QString & name, int size )
 {
-    struct utsname uts;
-    uname( &uts );
-    m_info[ OS_SYSNAME ] = uts.sysname;
-    m_info[ OS_RELEASE ] = uts.release;
-    m_info[ OS_VERSION ] = uts.version;
-    m_info[ OS_MACHINE ] = uts.machine;
-    m_info[ OS_HOSTNAME ] = uts.nodename;
-
-//     m_info[ OS_USER ] = KUser().loginName();
-
-#ifdef WITH_FEDORA
-    m_info[ OS_SYSTEM ] = readFromFile( "/etc/redhat-release" );
-#elif defined(WITH_SUSE)
-    m_info[ OS_SYSTEM ] = readFromFile( "/etc/SuSE-release" );
-#elif defined(WITH_DEBIAN)
-    m_info[ OS_SYSTEM ] = readFromFile( "/etc/debian_version" );
-#elif defined(WITH_UBUNTU)
-    m_info[ OS_SYSTEM ] = readFromFile ( "/etc/os-release", "NAME", "=" ).remove(QChar('\"'), Qt::CaseInsensitive) + " " + readFromFile ( "/etc/os-release", "VERSION", "=" ).remove(QChar('\"'), Qt::CaseInsensitive);
-#else
-    m_info[ OS_SYSTEM ] = i18nc( "Unknown operating system version", "Unknown" );
-#endif
-    m_info[ OS_SYSTEM ].replace("X86-64", "x86_64");
+    // the theme doesn't change under a running slave, look every icon up once
+    static QHash<QString, QString> imgs;
+    const QString key = name + QLatin1Char( '/' ) + QString::number( size );
+    QHash<QString, QString>::ConstIterator it = imgs.constFind( key );
+    if ( it == imgs.constEnd() )
+    {
+        QString path = KIconLoader::global()->iconPath( name, -size );
+        it = imgs.insert( key, QString( "<img src=\"file:%1\" width=\"%2\" height=\"%3\" valign=\"bottom\"/>" )
+                               .arg( htmlQuote(path) ).arg( size ).arg( size ) );
+    }
+    return it.value();
 }
 
 extern "C" int KDE_EXPORT kdemain(int argc, char **argv)
@@ -877,10 +1739,12 @@ extern "C" int KDE_EXPORT kdemain(int argc, char **argv)
 
 bool kio_sysinfoProtocol::fillMediaDevices()
 {
-    QEventLoop e;
-    while (e.processEvents()) {}
+    // deliver the device notifications which came in since the last request
+    QCoreApplication::processEvents();
+    if ( !m_deviceCache )
+        m_deviceCache = new DeviceCache( m_predicate );
 
-    const QList<Solid::Device> &deviceList = Solid::Device::listFromQuery(m_predicate);
+    const QMap<QString, DeviceEntry> & deviceList = m_deviceCache->devices();
 
     if (deviceList.isEmpty())
     {
@@ -888,88 +1752,120 @@ bool kio_sysinfoProtocol::fillMediaDevices()
         return false;
     }
 
-    m_devices.clear();
-
-    Q_FOREACH (const Solid::Device &device, deviceList)
+    // the entries are only rebuilt when Solid or the mount table reported a
+    // change, each request just fills in their space and I/O below
+    if ( m_deviceCache->takeChanged() )
     {
-        if (!device.isValid())
-            continue;
-
-        const Solid::StorageAccess *access = device.as<Solid::StorageAccess>();
-        const Solid::StorageVolume *volume = device.as<Solid::StorageVolume>();
-        const Solid::Block *block = device.as<Solid::Block>();
-        const Solid::StorageDrive *drive = device.parent().as<Solid::StorageDrive>();
-
-        DiskInfo di;
-
-        di.id = device.udi();
-        if (block)
-            di.deviceNode = block->device();
-        if (volume)
-            di.fsType = volume->fsType();
-        di.mounted = access && access->isAccessible();
-        di.removable = (di.mounted || device.is<Solid::OpticalDisc>()) && drive && drive->isRemovable();
-        if ( di.mounted )
-            di.mountPoint = access->filePath();
-
-        if (volume && !volume->label().isEmpty())
-            di.label = volume->label();
-        else if (!di.mountPoint.isEmpty())
-            di.label = di.mountPoint;
-        else
-            di.label = di.deviceNode;
+        m_solidDevices.clear();
+        Q_FOREACH (const DeviceEntry &device, deviceList)
+        {
+            DiskInfo di;
 
-        di.iconName = device.icon();
+            di.id = device.udi;
+            di.deviceNode = device.deviceNode;
+            di.fsType = device.fsType;
+            di.mounted = device.accessible;
+            di.removable = (di.mounted || device.opticalDisc) && device.removableDrive;
+            if ( di.mounted )
+                di.mountPoint = device.filePath;
+
+            if (!device.label.isEmpty())
+                di.label = device.label;
+            else if (!di.mountPoint.isEmpty())
+                di.label = di.mountPoint;
+            else
+                di.label = di.deviceNode;
 
-        di.total = di.avail = 0;
+            di.iconName = device.iconName;
 
-        if (volume)
-            di.total = volume->size();
+            di.total = device.size;
+            di.avail = 0;
+            di.unresponsive = false;
+            diskCells( di );
 
-        // calc the free/total space
-        struct statfs sfs;
-        if ( di.mounted && statfs( QFile::encodeName( di.mountPoint ), &sfs ) == 0 )
-        {
-            di.total = ( unsigned long long )sfs.f_blocks * sfs.f_bsize;
-            di.avail = ( unsigned long long )( getuid() ? sfs.f_bavail : sfs.f_bfree ) * sfs.f_bsize;
+            m_solidDevices.append( di );
         }
-
-        m_devices.append( di );
     }
 
-    // this is ugly workaround, should be in HAL but there is no LVM support
-    QRegExp rxlvm("^/dev/mapper/\\S*-\\S*");
-
-    const KMountPoint::List mountPoints = KMountPoint::currentMountPoints(KMountPoint::NeedRealDeviceName);
-
-    Q_FOREACH ( KMountPoint::Ptr mountPoint, mountPoints)
+    // LVM volumes aren't in Solid, take them from the mount table
+    if ( m_mounts.update() )
     {
-        if ( rxlvm.exactMatch( mountPoint->realDeviceName() ) )
+        m_lvmDevices.clear();
+        Q_FOREACH ( const MountEntry & mount, m_mounts.entries() )
         {
+            if ( !mount.lvm )
+                continue;
+
             DiskInfo di;
 
-            di.mountPoint = mountPoint->mountPoint();
+            di.mountPoint = mount.mountPoint;
             di.label = di.mountPoint;
             di.mounted = true;
-            di.removable = false; /* we don't want Solid to unmount KMountPoint */
-            di.deviceNode = mountPoint->realDeviceName();
-            di.fsType = mountPoint->mountType();
+            di.removable = false; /* we don't want Solid to unmount it */
+            di.deviceNode = mount.device;
+            di.fsType = mount.fsType;
             di.iconName = QString::fromLatin1( "drive-harddisk" );
 
             di.total = di.avail = 0;
+            di.unresponsive = false;
+            diskCells( di );
 
-            // calc the free/total space
-            struct statfs sfs;
-            if ( di.mounted && statfs( QFile::encodeName( di.mountPoint ), &sfs ) == 0 )
-            {
-                di.total = ( unsigned long long )sfs.f_blocks * sfs.f_bsize;
-                di.avail = ( unsigned long long )( getuid() ? sfs.f_bavail : sfs.f_bfree ) * sfs.f_bsize;
-            }
+            m_lvmDevices.append( di );
+        }
+    }
+    m_devices = m_solidDevices + m_lvmDevices;
 
-            m_devices.append( di );
+    // calc the free/total space, without letting a hung mount block us
+    QVector<DiskSpace::Request> requests;
+    QVector<int> requested;
+    for ( int i = 0; i < m_devices.size(); ++i )
+    {
+        if ( m_devices.at( i ).mounted )
+        {
+            DiskSpace::Request request;
+            request.mountPoint = m_devices.at( i ).mountPoint;
+            request.total = request.avail = 0;
+            request.state = DiskSpace::Failed;
+            requests.append( request );
+            requested.append( i );
         }
     }
 
+    const KConfigGroup cg( KGlobal::config(), "Disks" );
+    DiskSpace::query( requests, cg.readEntry( "StatfsTimeout", DISKSPACE_TIMEOUT_MS ),
+                      cg.readEntry( "UnresponsiveRetryInterval", DISKSPACE_RETRY_S ) );
+
+    QStringList sampled;
+    for ( int i = 0; i < requests.size(); ++i )
+    {
+        DiskInfo & di = m_devices[requested.at( i )];
+        switch ( requests.at( i ).state )
+        {
+        case DiskSpace::Ok:
+            di.total = requests.at( i ).total;
+            di.avail = requests.at( i ).avail;
+            sampled << di.mountPoint;
+            break;
+        case DiskSpace::Unresponsive:
+            di.unresponsive = true;
+            break;
+        default:
+            break;
+        }
+    }
+    if ( m_history )
+        m_history->setMountPoints( sampled );
+
+    // I/O activity since the previous request, joined by device number
+    m_diskStats.sample();
+    for ( QList<DiskInfo>::Iterator it = m_devices.begin(); it != m_devices.end(); ++it )
+    {
+        struct stat st;
+        if ( !it->deviceNode.isEmpty() && stat( QFile::encodeName( it->deviceNode ), &st ) == 0 && S_ISBLK( st.st_mode ) )
+            it->io = m_diskStats.rates( major( st.st_rdev ), minor( st.st_rdev ) );
+        else
+            it->io.valid = false;
+    }
 
     return true;
 }
@@ -987,28 +1883,15 @@ bool kio_sysinfoProtocol::batteryInfo()
         if ( device.is<Solid::Battery>() )
         {
             const Solid::Battery * battery = device.as<Solid::Battery>();
-            m_info[BATT_IS_PLUGGED] = battery->isPlugged() ? i18n( "yes" ) : i18n( "no" );
-            m_info[BATT_CHARGE_PERC] =  i18nc( "battery charge percent label", "%1%", battery->chargePercent() );
-            switch ( battery->chargeState() )
-            {
-            case Solid::Battery::NoCharge:
-                m_info[BATT_CHARGE_STATE] = i18nc( "battery charge state", "No Charge" );
-                break;
-            case Solid::Battery::Charging:
-                m_info[BATT_CHARGE_STATE] = i18nc( "battery charge state", "Charging" );
-                break;
-            case Solid::Battery::Discharging:
-                m_info[BATT_CHARGE_STATE] = i18nc( "battery charge state", "Discharging" );
-                break;
-            default:
-                m_info[BATT_CHARGE_STATE] = i18nc( "battery charge state", "Unknown" );
-            }
-            m_info[BATT_IS_RECHARGEABLE] = battery->isRechargeable() ? i18n( "yes" ) : i18n( "no" );
+            m_snapshot.setNumber( SysInfoSnapshot::BATT_IS_PLUGGED, battery->isPlugged() );
+            m_snapshot.setNumber( SysInfoSnapshot::BATT_CHARGE_PERC, battery->chargePercent() );
+            m_snapshot.setNumber( SysInfoSnapshot::BATT_CHARGE_STATE, battery->chargeState() );
+            m_snapshot.setNumber( SysInfoSnapshot::BATT_IS_RECHARGEABLE, battery->isRechargeable() );
         }
         else if ( device.is<Solid::AcAdapter>() )
         {
             const Solid::AcAdapter * ac = device.as<Solid::AcAdapter>();
-            m_info[AC_IS_PLUGGED] = ac->isPlugged() ? i18n( "yes" ) : i18n( "no" );
+            m_snapshot.setNumber( SysInfoSnapshot::AC_IS_PLUGGED, ac->isPlugged() );
         }
     }
 
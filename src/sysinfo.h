@@ -22,7 +22,7 @@
 #ifndef _sysinfo_H_
 #define _sysinfo_H_
 
-#include <qmap.h>
+#include <qsharedpointer.h>
 #include <qstringlist.h>
 
 #include <kurl.h>
@@ -31,9 +31,27 @@
 
 #include <solid/predicate.h>
 
+#include "cpustat.h"
+#include "diskstats.h"
+#include "mounttable.h"
+#include "numainfo.h"
+#include "pressure.h"
+#include "samplerdata.h"
+#include "sharedsnapshot.h"
+#include "snapshot.h"
+
 #define GFX_VENDOR_ATI "ATI Technologies Inc."
 #define GFX_VENDOR_NVIDIA "NVIDIA Corporation"
 
+class QThreadPool;
+class DeviceCache;
+class History;
+class SnapshotLog;
+struct CollectorBatch;
+typedef QSharedPointer<CollectorBatch> CollectorBatchPtr;
+struct CollectorRun;
+typedef QSharedPointer<CollectorRun> CollectorRunPtr;
+
 struct DiskInfo
 {
     // taken from media:/
@@ -49,6 +67,11 @@ struct DiskInfo
 
     // own stuff
     quint64 total, avail; // space on device
+    bool unresponsive;    // statfs() didn't answer in time, space is unknown
+    DiskIoRates io;       // activity since the previous request
+
+    // the parts of its table row which don't change between requests
+    QString headCells, tailCells;
 };
 
 
@@ -66,52 +89,125 @@ public:
     virtual void get( const KUrl& url );
 
     /**
-     * Info field
+     * The collectors which don't need Solid
      */
-    enum
+    enum CollectorId
     {
-        MEM_TOTALRAM = 0,       // in sysinfo.mem_unit
-        MEM_FREERAM,
-        MEM_TOTALSWAP,
-        MEM_FREESWAP,
-        SYSTEM_UPTIME,          // in seconds
-        CPU_MODEL,
-        CPU_SPEED,              // in MHz
-        CPU_CORES,
-        CPU_TEMP,
-        OS_SYSNAME,             // man 2 uname
-        OS_RELEASE,
-        OS_VERSION,
-        OS_MACHINE,
-        OS_USER,                // username
-        OS_SYSTEM,              // OS version
-        OS_HOSTNAME,
-        GFX_VENDOR,              // Display stuff
-        GFX_MODEL,
-        GFX_2D_DRIVER,
-        GFX_3D_DRIVER,
-        BATT_IS_PLUGGED,        // see Solid::Battery
-        BATT_CHARGE_PERC,
-        BATT_CHARGE_STATE,
-        BATT_IS_RECHARGEABLE,
-        AC_IS_PLUGGED,          // see Solid::AcAdapter
-        SYSINFO_LAST,
-        KF5_VERSION,
-        QT5_VERSION,
-        KDEAPPS_VERSION,
-        WAYLAND_VER
+        COLL_CPU = 0,
+        COLL_OS,
+        COLL_KDE,
+        COLL_GL,
+        COLL_WAYLAND,
+        COLL_MEMORY,
+        COLL_COUNT
     };
 
+    /**
+     * Run the collectors in the bitmask @p which (1 << CollectorId) one after
+     * the other on the calling thread, for the sampler daemon
+     * @return bitmask of the collectors which succeeded
+     */
+    static int collect( SysInfoSnapshot & info, int which );
+
+    /**
+     * The snapshot log as set up in [Log] of kio_sysinforc, 0 if disabled
+     * @param interval set to the minimum time between records, in ms
+     */
+    static SnapshotLog * createLog( qint64 & interval );
+
+    /**
+     * The usage history as set up in [History] of kio_sysinforc, already
+     * sampling, 0 if disabled
+     */
+    static History * createHistory();
+
+    /**
+     * Render the headCells and tailCells of @p di
+     */
+    static void diskCells( DiskInfo & di );
+
+    /**
+     * The two table rows of @p di in the disk table, @p spaceHistory goes
+     * after its available space
+     */
+    static QString diskRows( const DiskInfo & di, const QString & spaceHistory );
+
 private:
+    /**
+     * Serve sysinfo:/?format=json, a machine readable document made from
+     * the same snapshot as the page
+     */
+    void jsonGet();
+
+    /**
+     * Serve sysinfo:/?format=json&at=<time_t>, the snapshot logged last at
+     * or before that time, see SnapshotLog
+     */
+    void loggedGet( const KUrl & url );
+
+    /**
+     * Serve sysinfo:/?format=json&from=<time_t>[&to=<time_t>], every
+     * snapshot logged in that range, oldest first
+     */
+    void loggedRangeGet( const KUrl & url );
+
+    /**
+     * Serve sysinfo:/section/<name>, the contents of one section of the page
+     * (os, display, battery, cpu, memory, pressure, net, disks), so the part
+     * can update it in place. Only the collectors of that section are run.
+     */
+    void sectionGet( const KUrl & url );
+
+    /**
+     * Take the collected fields and the SamplerData from the sampler daemon,
+     * if one is running
+     * @return the bitmask of its collectors which succeeded, -1 if there
+     * is no sampler or it stopped publishing
+     */
+    int readSampler();
+
+    /**
+     * CPU load, frequency policies, sensors and pressure for the current
+     * request, from the sampler if it published them, else read here.
+     * The load is m_cpuStat's then, which the caller samples.
+     */
+    const CpuStat & cpuStat() const;
+    const CpuFreq * cpuFreq();                  // 0 without cpufreq
+    QVector<SensorReading> sensorReadings();
+    bool pressureStats( int resource, PressureStats & stats );
+
+    /**
+     * Usage history for the sparklines, from the sampler if it published
+     * the data, else from m_history. historyMinutes() is 0 without any.
+     */
+    int historyMinutes() const;
+    QVector<qint64> historyPoints( int metric ) const;
+    QVector<qint64> diskHistory( const QString & mountPoint ) const;
+
+    /**
+     * Collector filling its fields of a snapshot on the worker pool
+     * @return false if the corresponding section should not be shown
+     */
+    typedef bool (*Collector)( SysInfoSnapshot & info );
+
+    static Collector collector( int id );
+
+    /**
+     * Start the collectors in the bitmask @p which on the worker pool,
+     * except those still running for an earlier request, which are joined
+     * @return their batch, null if @p which is 0
+     */
+    CollectorBatchPtr startCollectors( int which );
+
     /**
      * Gather basic memory info
      */
-    void memoryInfo();
+    static bool memoryInfo( SysInfoSnapshot & info );
 
     /**
      * Gather CPU info
      */
-    void cpuInfo();
+    static bool cpuInfo( SysInfoSnapshot & info );
 
     /**
      * @return a formatted table with disk partitions
@@ -121,52 +217,146 @@ private:
     /**
      * Get info about kernel and OS version (uname)
      */
-    void osInfo();
+    static bool osInfo( SysInfoSnapshot & info );
 
     /**
      * Gather basic OpenGL info
      */
-    bool glInfo();
-    
+    static bool glInfo( SysInfoSnapshot & info );
+
     /**
      * Gather KF5, Qt5 and KDE Apps info
      */
-    bool kdeInfo();
-    
+    static bool kdeInfo( SysInfoSnapshot & info );
+
     /**
      * Gather Wayland info
      */
-    void waylandInfo();
+    static bool waylandInfo( SysInfoSnapshot & info );
 
     /**
      * Gather battery / AC adapter status
+     *
+     * Talks to Solid, so it has to run in the slave's main thread.
      */
     bool batteryInfo();
-    
+
+    /**
+     * Page sections, rendered from m_snapshot. get() sends each one as soon as
+     * the collectors it depends on are done.
+     */
+    QString osSection( bool os, bool kde );
+    QString displaySection( bool gl );
+    QString batterySection();
+    QString cpuSection();
+    QString memorySection();
+    QString pressureSection();
+    QString netSection();
+    QString disksSection();
+
     /**
      * Helper function to return default hd icon
      * @return hdimage with 32x32 pixels
      */
-    QString hdicon() const;
+    static QString hdicon();
 
     /**
      * Helper function to locate a KDE icon
      * @return img tag with full path to the icon
      */
-    QString icon( const QString & name, int size = KIconLoader::SizeSmall ) const;
+    static QString icon( const QString & name, int size = KIconLoader::SizeSmall );
 
     /**
-     * Fill the list of devices (m_devices) with data from the media KIO protocol
+     * Fill the list of devices (m_devices) from m_deviceCache and the mount table
      * @return true on success
      */
     bool fillMediaDevices();
 
     /**
-     * Map holding the individual info attributes
+     * Everything gathered for the current request
+     */
+    SysInfoSnapshot m_snapshot;
+
+    /**
+     * Worker pool running the collectors which don't need Solid
      */
-    QMap<int, QString> m_info;
+    QThreadPool *m_pool;
 
+    /**
+     * Latest run of each collector on m_pool, and the latest one known to
+     * be done, see startCollectors()
+     */
+    QVector<CollectorRunPtr> m_runs;
+    QVector<CollectorRunPtr> m_completedRuns;
+
+    /**
+     * Storage devices as last reported by Solid, created on first use
+     */
+    DeviceCache *m_deviceCache;
+
+    /**
+     * The devices of the last request, made of the ones from Solid and the
+     * LVM volumes, which are only rebuilt when their source changed
+     */
     QList<DiskInfo> m_devices;
+    QList<DiskInfo> m_solidDevices;
+
+    /**
+     * Mount table index and the LVM volumes found in it
+     */
+    MountTable m_mounts;
+    QList<DiskInfo> m_lvmDevices;
+
+    /**
+     * Per-CPU /proc/stat sampler, sampled on every request
+     */
+    CpuStat m_cpuStat;
+
+    /**
+     * /proc/diskstats sampler, its previous sample is kept between requests
+     */
+    DiskStats m_diskStats;
+
+    /**
+     * PSI triggers, armed if [Pressure] Triggers is set. Their events stay
+     * pending between requests, so a stall since the previous page is
+     * flagged even if the averages have decayed by now.
+     */
+    PressureMonitor m_pressure;
+
+    /**
+     * Latest snapshot of the sampler daemon, see readSampler()
+     */
+    SharedSnapshot m_sampler;
+
+    /**
+     * What the sampler measured besides the snapshot, only valid for the
+     * current request if m_haveSamplerData
+     */
+    SamplerData m_samplerData;
+    QByteArray m_samplerBuffer;
+    bool m_haveSamplerData;
+    CpuFreq m_freq;
+
+    /**
+     * Usage history sampled by the slave itself, only running while no
+     * sampler daemon is, readSampler() stops it once one publishes again.
+     * 0 if disabled or not needed yet.
+     */
+    History *m_history;
+
+    /**
+     * Snapshots collected here are appended to it, unless the sampler
+     * daemon takes care of that. 0 if disabled.
+     */
+    SnapshotLog *m_log;
+    qint64 m_logInterval;
+    qint64 m_lastLogged;
+
+    /**
+     * Per-node memory, kept to reuse its storage
+     */
+    QVector<NumaNodeInfo> m_numaNodes;
     Solid::Predicate m_predicate;
 };
 
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////////////
+// timeseries.cpp                                                       //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#include "timeseries.h"
+
+// a point without value, the previous value carries over for the deltas
+#define MISSING_DELTA qint32( 0x80000000 )
+
+const qint64 TimeSeries::NO_VALUE = Q_INT64_C( 0x8000000000000000 );
+
+TimeSeries::TimeSeries( int capacity, int resolution, qint64 unit )
+    : m_blocks( ( capacity + BLOCK_SIZE - 1 ) / BLOCK_SIZE + 2 ),
+      m_resolution( qMax( resolution, 1 ) ),
+      m_unit( qMax( unit, Q_INT64_C( 1 ) ) ),
+      m_ring( new Block[m_blocks] ),
+      m_count( 0 ),
+      m_firstSlot( 0 ),
+      m_last( 0 )
+{
+}
+
+TimeSeries::~TimeSeries()
+{
+    delete[] m_ring;
+}
+
+void TimeSeries::store( qint64 units, bool missing )
+{
+    const qint64 index = m_count;
+    Block & block = m_ring[( index / BLOCK_SIZE ) % m_blocks];
+    const int offset = index % BLOCK_SIZE;
+    qint32 delta = MISSING_DELTA;
+    if ( offset == 0 )
+    {
+        // each block starts from a full value, so it decodes on its own
+        if ( !missing )
+        {
+            m_last = units;
+            delta = 0;
+        }
+        block.anchor = m_last;
+    }
+    else if ( !missing )
+    {
+        // clamped, so that the readers still arrive at m_last if the unit
+        // was too small for the metric
+        delta = qint32( qBound( Q_INT64_C( -0x7fffffff ), units - m_last, Q_INT64_C( 0x7fffffff ) ) );
+        m_last += delta;
+    }
+    block.deltas[offset] = delta;
+
+    // publish the point only once it's complete
+    __sync_synchronize();
+    m_count = index + 1;
+}
+
+void TimeSeries::append( qint64 time, qint64 value )
+{
+    const qint64 slot = time / m_resolution;
+    if ( !m_count )
+        m_firstSlot = slot;
+    const qint64 next = m_firstSlot + m_count;
+    if ( slot < next )
+        return;
+
+    // fill the gap, but with no more than a ring full of missing points
+    const qint64 limit = qint64( m_blocks ) * BLOCK_SIZE;
+    if ( slot - next > limit )
+        m_firstSlot += slot - next - limit;
+    while ( m_firstSlot + m_count < slot )
+        store( 0, true );
+    store( value / m_unit, false );
+}
+
+qint64 TimeSeries::points( QVector<qint64> & values ) const
+{
+    values.resize( 0 );
+
+    // the block the writer is in is read up to the published count; the
+    // one after it is next to be overwritten and skipped
+    const qint64 end = m_count;
+    __sync_synchronize();
+    const qint64 firstBlock = qMax( Q_INT64_C( 0 ), end / BLOCK_SIZE - ( m_blocks - 2 ) );
+
+    values.reserve( end - firstBlock * BLOCK_SIZE );
+    for ( qint64 index = firstBlock * BLOCK_SIZE; index < end; )
+    {
+        const Block & block = m_ring[( index / BLOCK_SIZE ) % m_blocks];
+        qint64 value = block.anchor;
+        for ( int offset = 0; offset < BLOCK_SIZE && index < end; ++offset, ++index )
+        {
+            const qint32 delta = block.deltas[offset];
+            if ( delta == MISSING_DELTA )
+            {
+                values.append( NO_VALUE );
+                continue;
+            }
+            value += delta;
+            values.append( value * m_unit );
+        }
+    }
+
+    // drop what the writer may have overwritten while we were copying
+    __sync_synchronize();
+    const qint64 end2 = m_count;
+    const qint64 firstBlock2 = qMax( Q_INT64_C( 0 ), end2 / BLOCK_SIZE - ( m_blocks - 2 ) );
+    if ( firstBlock2 > firstBlock )
+        values.remove( 0, int( qMin( qint64( values.size() ), ( firstBlock2 - firstBlock ) * BLOCK_SIZE ) ) );
+
+    return ( m_firstSlot + end - 1 ) * m_resolution;
+}
@@ -0,0 +1,96 @@
+//////////////////////////////////////////////////////////////////////////
+// timeseries.h                                                         //
+//                                                                      //
+// Copyright (C)  2026  kio_sysinfo developers                          //
+//                                                                      //
+// This program is free software; you can redistribute it and/or        //
+// modify it under the terms of the GNU General Public License          //
+// as published by the Free Software Foundation; either version 2       //
+// of the License, or (at your option) any later version.               //
+//                                                                      //
+// This program is distributed in the hope that it will be useful,      //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of       //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the        //
+// GNU General Public License for more details.                         //
+//                                                                      //
+// You should have received a copy of the GNU General Public License    //
+// along with this program; if not, write to the Free Software          //
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA        //
+// 02110-1301, USA.                                                     //
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef _timeseries_H_
+#define _timeseries_H_
+
+#include <qglobal.h>
+#include <qvector.h>
+
+/**
+ * Fixed size history of one numeric metric at a fixed resolution.
+ *
+ * Points are delta encoded: the ring is split into blocks of BLOCK_SIZE
+ * points, each block stores its first value in full and the others as a
+ * 32 bit difference to their predecessor, in multiples of a unit chosen
+ * per metric (e.g. MiB for memory). A point takes 4 bytes instead of 8.
+ *
+ * There is one writer and any number of readers, none of them locks:
+ * the writer publishes the number of points after storing one, readers
+ * copy what was published and drop the block the writer may have started
+ * to overwrite meanwhile.
+ */
+class TimeSeries
+{
+public:
+    enum { BLOCK_SIZE = 32 };
+
+    /**
+     * Marks a point without a value in points()
+     */
+    static const qint64 NO_VALUE;
+
+    /**
+     * @param capacity number of points kept at least, rounded up to whole
+     * blocks; two more are allocated for the writer to work in
+     * @param resolution ms per point
+     * @param unit values are stored as multiples of it
+     */
+    TimeSeries( int capacity, int resolution, qint64 unit = 1 );
+    ~TimeSeries();
+
+    /**
+     * Writer only: record @p value for the monotonic time @p time in ms.
+     * Points skipped since the previous call are stored as missing, a
+     * second value for the same point is ignored.
+     */
+    void append( qint64 time, qint64 value );
+
+    /**
+     * Any thread: copy the history into @p values, oldest point first,
+     * NO_VALUE where there is none
+     * @return the time of the newest point
+     */
+    qint64 points( QVector<qint64> & values ) const;
+
+    int resolution() const { return m_resolution; }
+
+private:
+    Q_DISABLE_COPY( TimeSeries )
+
+    struct Block
+    {
+        qint64 anchor;              // value of the first point, in units
+        qint32 deltas[BLOCK_SIZE];  // to the previous point, in units
+    };
+
+    void store( qint64 units, bool missing );
+
+    const int m_blocks;
+    const int m_resolution;
+    const qint64 m_unit;
+    Block * const m_ring;
+    volatile qint64 m_count;        // points written since the start
+    qint64 m_firstSlot;             // time slot of point 0
+    qint64 m_last;                  // value of the newest point, in units
+};
+
+#endif